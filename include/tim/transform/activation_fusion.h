@@ -0,0 +1,68 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_ACTIVATION_FUSION_H_
+#define TIM_ACTIVATION_FUSION_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Tensor;
+}
+
+namespace transform {
+
+struct ActivationFusionReport {
+  /// Relu ops merged into the Conv2d/FullyConnected before them
+  uint32_t fused_activations{0};
+  /// Adds of a per-channel constant merged into the bias
+  uint32_t fused_biases{0};
+  /// Bytes of the intermediate tensors which are no longer written and read
+  uint64_t saved_bytes{0};
+};
+
+/// Merge Conv2d/FullyConnected -> [Add(constant)] -> Relu chains into one
+/// operation: a per-channel constant add goes into the float32 bias and the
+/// relu turns the node into the fused CONV_RELU/FCL_RELU op. Only chains whose
+/// intermediate tensors have no other reader are merged. Run it after
+/// LayoutInference, which has no handler for the fused CONV_RELU/FCL_RELU
+/// ops.
+std::pair<
+    /*graph after fusion*/
+    std::shared_ptr<vx::Graph>,
+    /* tensor mapping between original graph and graph after fusion*/
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+FuseActivations(const std::shared_ptr<vx::Graph>& src_graph,
+                std::shared_ptr<vx::Context>& ctx,
+                ActivationFusionReport* report = nullptr);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -0,0 +1,68 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_COMMON_SUBEXPRESSION_ELIMINATION_H_
+#define TIM_COMMON_SUBEXPRESSION_ELIMINATION_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Tensor;
+}
+
+namespace transform {
+
+struct CommonSubexpressionReport {
+  /// Operations dropped for an identical one computed before them
+  uint32_t merged_ops{0};
+  /// Bytes of the transient tensors which are no longer written
+  uint64_t saved_bytes{0};
+};
+
+/// Copy the graph computing each distinct operation once. Operations of the
+/// same kind, with equal parameters, equal output specs and the same input
+/// tensors are merged, and readers of the dropped outputs read the kept
+/// ones, so duplicated subtrees such as the Transpose/Reshape/DataConvert
+/// heads of merged models or BatchFuse output collapse from the inputs down.
+/// Operations writing graph outputs are kept. Parameters behind pointers are
+/// only compared for Transpose, Reshape and Squeeze, other operations with
+/// such parameters are never merged.
+std::pair<
+    /*graph after common subexpression elimination*/
+    std::shared_ptr<vx::Graph>,
+    /* tensor mapping between original graph and graph after elimination*/
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+EliminateCommonSubexpressions(const std::shared_ptr<vx::Graph>& src_graph,
+                              std::shared_ptr<vx::Context>& ctx,
+                              CommonSubexpressionReport* report = nullptr);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -0,0 +1,65 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_DEAD_OP_ELIMINATION_H_
+#define TIM_DEAD_OP_ELIMINATION_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Tensor;
+}
+
+namespace transform {
+
+struct DeadOpEliminationReport {
+  /// Operations none of whose outputs reach a graph output
+  uint32_t removed_ops{0};
+  /// Tensors only those operations used
+  uint32_t removed_tensors{0};
+  /// Bytes of the removed transient tensors
+  uint64_t saved_bytes{0};
+};
+
+/// Copy the graph without the operations whose results never reach a graph
+/// output, such as debug branches or consumers of unused Split outputs.
+/// Unused outputs of kept operations stay since the operation writes them.
+std::pair<
+    /*graph after dead op elimination*/
+    std::shared_ptr<vx::Graph>,
+    /* tensor mapping between original graph and graph after elimination*/
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+EliminateDeadOps(const std::shared_ptr<vx::Graph>& src_graph,
+                 std::shared_ptr<vx::Context>& ctx,
+                 DeadOpEliminationReport* report = nullptr);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -24,7 +24,9 @@
 #ifndef TIM_LAYOUT_INFERENCE_H_
 #define TIM_LAYOUT_INFERENCE_H_
 
+#include <cstdint>
 #include <map>
+#include <memory>
 #include <vector>
 
 
@@ -39,6 +41,24 @@ namespace vx {
 
 namespace transform {
 class IPermuteVector;
+
+struct PermuteOptimizationReport {
+  /// Transposes dropped as identities or merged into the one before them
+  uint32_t removed{0};
+  /// Transposes of constants applied to the constant data
+  uint32_t folded{0};
+  /// Bytes read by the Transposes left in the graph
+  uint64_t transpose_bytes{0};
+};
+
+enum class LayoutInferenceMode {
+  /// Every op takes its preferred layout in the order it is visited
+  GREEDY,
+  /// Search the layouts ops align their inputs to for the assignment that
+  /// moves the fewest bytes through Transposes, takes one inference per trial
+  GLOBAL_COST,
+};
+
 std::pair<
     /*graph after layout inference*/
     std::shared_ptr<vx::Graph>,
@@ -49,7 +69,21 @@ LayoutInference(
     std::shared_ptr<vx::Context>& ctx,
     std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<IPermuteVector>>
         tensor_pv_map = std::map<std::shared_ptr<vx::Tensor>,
-                                 std::shared_ptr<IPermuteVector>>());
+                                 std::shared_ptr<IPermuteVector>>(),
+    PermuteOptimizationReport* report = nullptr,
+    LayoutInferenceMode mode = LayoutInferenceMode::GREEDY);
+
+/// Compose adjacent Transposes, drop the ones which end up as identities and
+/// apply the ones on constants to the data. LayoutInference runs it on the
+/// graph it builds, it can be run on any graph too.
+std::pair<
+    /*graph after permute optimization*/
+    std::shared_ptr<vx::Graph>,
+    /* tensor mapping between original graph and optimized graph*/
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+OptimizePermutes(const std::shared_ptr<vx::Graph>& src_graph,
+                 std::shared_ptr<vx::Context>& ctx,
+                 PermuteOptimizationReport* report = nullptr);
 
 }  // namespace transform
 }  // namespace tim
@@ -0,0 +1,68 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_RESHAPE_SIMPLIFICATION_H_
+#define TIM_RESHAPE_SIMPLIFICATION_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+    class Tensor;
+}
+
+namespace transform {
+
+struct ReshapeSimplificationReport {
+  /// Reshape/Squeeze ops folded into a later Reshape of the same chain
+  uint32_t collapsed_ops{0};
+  /// Ops left as a Reshape to the shape their chain started from
+  uint32_t removed_identities{0};
+  /// Bytes of the transient tensors which are no longer written
+  uint64_t saved_bytes{0};
+};
+
+/// Copy the graph with every chain of Reshape/Squeeze ops turned into at most
+/// one Reshape from the tensor the chain starts from, and none when that
+/// tensor already has the final shape. Intermediate results still read by
+/// other ops are kept. Shape-only ops keep the element order in the source
+/// layout, so the pass can run before LayoutInference, which then reverses
+/// the permute of the chain input once instead of at every op, or after it.
+std::pair<
+    /*graph after reshape simplification*/
+    std::shared_ptr<vx::Graph>,
+    /* tensor mapping between original graph and graph after simplification*/
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+SimplifyReshapes(const std::shared_ptr<vx::Graph>& src_graph,
+                 std::shared_ptr<vx::Context>& ctx,
+                 ReshapeSimplificationReport* report = nullptr);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -24,8 +24,10 @@
 #ifndef TIM_VX_COMPILE_OPTION_H_
 #define TIM_VX_COMPILE_OPTION_H_
 
+#include <cstdint>
 #include <map>
 #include <memory>
+#include <string>
 
 namespace tim {
 namespace vx {
@@ -38,6 +40,18 @@ class CompileOption {
   bool isRelaxMode() const;
   bool setRelaxMode(bool enable = false);
 
+  /// Directory of the compiled graph cache, caching is disabled if empty.
+  /// A graph compiled before with the same structure, parameters, constant
+  /// data and driver is loaded from the cache instead of being recompiled.
+  /// Graphs with custom ops or NBG ops are always compiled.
+  const std::string& getCacheDir() const;
+  const std::string& setCacheDir(const std::string& dir);
+
+  /// Least recently used graphs are evicted once the cache directory is
+  /// larger than this, 0 means unbounded.
+  uint64_t getCacheSizeLimit() const;
+  uint64_t setCacheSizeLimit(uint64_t bytes);
+
   static CompileOption DefaultOptions;
 
  private:
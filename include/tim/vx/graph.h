@@ -28,9 +28,15 @@
 #include "vsi_feat_ops_def.h"
 #endif
 
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <future>
 #include <memory>
 #include <vector>
 
+#include "tim/vx/profile.h"
+
 namespace tim {
 namespace vx {
 
@@ -39,6 +45,26 @@ struct TensorSpec;
 struct DmaBufferDesc;
 class Operation;
 
+/// Buffer plan of the TRANSIENT tensors, see Graph::GetMemoryReport().
+struct MemoryReport {
+  /// Live range of one tensor over the execution order, both ends included
+  struct Block {
+    uint32_t tensor_id{0};  // Tensor::GetId()
+    uint32_t first{0};      // position of the op writing it
+    uint32_t last{0};       // position of the last op reading it
+    uint64_t size{0};
+    uint64_t offset{0};     // offset in the shared arena
+  };
+
+  std::vector<Block> blocks;
+  /// Bytes of all transient tensors, what no buffer reuse at all needs
+  uint64_t total_bytes{0};
+  /// Most bytes live at once, no plan can do better
+  uint64_t peak_bytes{0};
+  /// Arena bytes needed when blocks live at different times share memory
+  uint64_t arena_bytes{0};
+};
+
 class Graph {
  public:
   virtual ~Graph() {}
@@ -66,6 +92,50 @@ class Graph {
 
   virtual bool Run() = 0;
 
+  /// Run with per-call user buffers, bound in the order of InputsTensor()
+  /// and OutputsTensor(). Each buffer must hold GetSpec().GetByteSize() bytes
+  /// and stay valid until the next Run. 64-byte aligned buffers are swapped
+  /// in as tensor handles without copying; others fall back to a copy.
+  /// Copying data in or out of an io tensor afterwards sees the buffers of
+  /// the last run.
+  virtual bool Run(const std::vector<const void*>& inputs,
+                   const std::vector<void*>& outputs) = 0;
+
+  using RunCallback = std::function<void(bool)>;
+
+  /// Queue a run on the graph's worker and return at once. The future, and
+  /// `callback` if given, receive the result from the worker thread. Blocks
+  /// while SetMaxInFlight() runs are already queued or executing. Run()
+  /// waits for queued runs to finish first.
+  /// `callback` runs on the worker: Run() fails there, and so does RunAsync()
+  /// once the limit is reached, since both would wait for the callback.
+  virtual std::future<bool> RunAsync(RunCallback callback = nullptr) = 0;
+
+  /// Asynchronous Run(inputs, outputs), the buffers must stay untouched
+  /// until the run completes.
+  virtual std::future<bool> RunAsync(const std::vector<const void*>& inputs,
+                                     const std::vector<void*>& outputs,
+                                     RunCallback callback = nullptr) = 0;
+
+  /// Limit of runs queued or executing for RunAsync, 2 by default.
+  virtual void SetMaxInFlight(uint32_t count) = 0;
+
+  /// Record device time, kernel type and tensor traffic of every operation
+  /// on each Run(). Call it before Compile(): profiled graphs bypass the
+  /// compile cache since a cached binary has no per-node breakdown. It
+  /// turns on driver performance counters for the whole context.
+  virtual void EnableProfiling(bool enable = true) = 0;
+
+  /// Profile of the runs since profiling was enabled
+  virtual GraphProfile GetProfile() = 0;
+
+  /// Live ranges and buffer plan of the transient tensors in the execution
+  /// order picked by Compile(). Compile() runs the ops in an order lowering
+  /// the peak unless VSI_NN_ENABLE_MEMORY_SCHEDULE=0. The plan is built on
+  /// the first call, not by Compile(). Empty before Compile() or when the
+  /// graph was loaded from the compile cache.
+  virtual MemoryReport GetMemoryReport() = 0;
+
   template <typename OpType, typename... Params>
   std::shared_ptr<OpType> CreateOperation(Params... parameters) {
     auto op = std::make_shared<OpType>(this, parameters...);
@@ -78,11 +148,11 @@ class Graph {
 
   virtual void UpdateTensorConsumersMap(
       const std::shared_ptr<Tensor>& tensor,
-      const Operation* op) = 0;
+      const std::shared_ptr<Operation>& op) = 0;
 
   virtual void UpdateTensorProducerMap(
       const std::shared_ptr<Tensor>& tensor,
-      const Operation* op) = 0;
+      const std::shared_ptr<Operation>& op) = 0;
 
   virtual const std::vector<std::shared_ptr<Operation>> GetConsumersOp(
       std::shared_ptr<Tensor> tensor) const = 0;
@@ -92,8 +162,19 @@ class Graph {
 
   virtual void PrintGraph() const = 0;
 
+  /// Stable 128-bit hash of the graph, built up as ops are bound. It covers
+  /// op kinds, op parameters as set when the op is first bound, tensor specs
+  /// and the topology. Constant payloads are read back from the graph and
+  /// hashed, once each, the first time `with_constants` is true.
+  virtual std::array<uint64_t, 2> Fingerprint(bool with_constants = false) = 0;
+
   const std::vector<std::shared_ptr<Tensor>> GetConstantInputs() const;
 
+  /// Operations in the order they were created
+  const std::vector<std::shared_ptr<Operation>>& OpVector() const {
+    return op_vector_;
+  }
+
  protected:
   std::vector<std::shared_ptr<tim::vx::Operation>> op_vector_;
 };
@@ -24,6 +24,8 @@
 #ifndef TIM_VX_OPERATION_H_
 #define TIM_VX_OPERATION_H_
 
+#include <memory>
+
 #include "tim/vx/graph.h"
 #include "tim/vx/tensor.h"
 
@@ -32,7 +34,7 @@ namespace vx {
 
 class OpImpl;
 
-class Operation {
+class Operation : public std::enable_shared_from_this<Operation> {
  public:
   Operation();
   virtual ~Operation();
@@ -0,0 +1,107 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_VX_PLATFORM_DEVICE_POOL_H_
+#define TIM_VX_PLATFORM_DEVICE_POOL_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tim/vx/platform/native.h"
+
+namespace tim {
+namespace vx {
+namespace platform {
+
+// Runs requests for a set of models on several devices. Every model is
+// compiled once per device. A request goes to the device with the least
+// queued work. A device that runs out of work steals the newest request of
+// the most loaded device. Each device runs one request at a time, so the
+// executables' tensors are never shared between runs.
+class DevicePool : public std::enable_shared_from_this<DevicePool> {
+ public:
+  using model_id_t = uint32_t;
+  // Builds the graph of a model, called once per device.
+  using GraphBuilder =
+      std::function<std::shared_ptr<Graph>(const std::shared_ptr<Context>&)>;
+
+  struct Request {
+    model_id_t model;
+    // Host buffers, one per graph input/output in graph order.
+    std::vector<const void*> inputs;
+    std::vector<void*> outputs;
+    // Called from a device worker after the outputs were copied out.
+    std::function<void(bool)> done;
+  };
+
+  static std::shared_ptr<DevicePool> Create(
+      const std::vector<std::shared_ptr<IDevice>>& devices);
+
+  // Returns the id of the model to use in requests. Models may be added
+  // while earlier ones run.
+  model_id_t AddModel(const GraphBuilder& builder);
+  bool Dispatch(const Request& request);
+  // Blocks until every dispatched request has completed.
+  void Wait();
+  size_t DeviceCount() const;
+  // Requests run by every device, including stolen ones.
+  std::vector<size_t> CompletedPerDevice();
+
+ protected:
+  explicit DevicePool(const std::vector<std::shared_ptr<IDevice>>& devices);
+
+  struct Model {
+    std::shared_ptr<IExecutable> executable;
+    std::vector<std::shared_ptr<ITensorHandle>> inputs;
+    std::vector<std::shared_ptr<ITensorHandle>> outputs;
+    std::vector<uint32_t> input_bytes;
+  };
+
+  struct Slot {
+    std::shared_ptr<IExecutor> executor;
+    // Runs in flight refer to their model, a deque keeps it in place
+    std::deque<Model> models;
+    std::deque<Request> queue;
+    bool busy = false;
+    size_t completed = 0;
+  };
+
+  void Start(size_t device, const Request& request);
+  void Finish(size_t device, const Request& request, bool status);
+  // Picks the next request for an idle device, caller holds mtx_.
+  bool Next(size_t device, Request& request);
+
+  std::vector<Slot> slots_;
+  model_id_t model_count_ = 0;
+  std::mutex mtx_;
+  Completion completion_;
+};
+
+}  // namespace platform
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_PLATFORM_DEVICE_POOL_H_ */
@@ -30,6 +30,15 @@ namespace tim {
 namespace vx {
 namespace platform {
 
+struct NativeDeviceOptions {
+  // Worker threads per device. 0 splits the host cores between the
+  // enumerated devices, at most 2 per device.
+  uint32_t worker_count = 0;
+  // CPUs the workers may run on, bit i for CPU i. 0 keeps the default
+  // affinity.
+  uint64_t cpu_mask = 0;
+};
+
 class NativeDevice : public IDevice {
  public:
   ~NativeDevice(){};
@@ -37,7 +46,8 @@ class NativeDevice : public IDevice {
   virtual bool Trigger(bool async = false, async_callback cb = NULL) = 0;
   virtual bool DeviceExit() = 0;
   virtual void WaitDeviceIdle() = 0;
-  static std::vector<std::shared_ptr<IDevice>> Enumerate();
+  static std::vector<std::shared_ptr<IDevice>> Enumerate(
+      const NativeDeviceOptions& options = NativeDeviceOptions());
 
 };
 
@@ -50,6 +60,7 @@ class NativeExecutable : public IExecutable{
   void GetOutput(const std::vector<std::shared_ptr<ITensorHandle>>& th) override;
   bool Submit(const std::shared_ptr<IExecutable>& ref, bool after = true) override;
   bool Trigger(bool async = false) override;
+  bool Launch(const IDevice::async_callback& done) override;
   std::shared_ptr<ITensorHandle> AllocateTensor(const TensorSpec& tensor_spec) override;
   bool Verify() override;
 
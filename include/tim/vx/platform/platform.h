@@ -28,6 +28,8 @@
 #include <vector>
 #include <functional>
 #include <iostream>
+#include <mutex>
+#include <condition_variable>
 #include "tim/vx/graph.h"
 #include "tim/vx/tensor.h"
 #include "tim/vx/context.h"
@@ -51,6 +53,19 @@ class ExecutableSet;
 class IExecutor;
 class ITensorHandle;
 
+// Counts runs in flight so callers can block until all of them finished.
+class Completion {
+ public:
+  void Begin();
+  void Finish();
+  void Wait();
+
+ protected:
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  size_t pending_ = 0;
+};
+
 std::shared_ptr<IExecutable> Compile(const std::shared_ptr<Graph>& graph, const std::shared_ptr<IExecutor>& executor);
 std::shared_ptr<IExecutable> CreateExecutableSet(const std::vector<std::shared_ptr<IExecutable>>& executables);
 
@@ -75,7 +90,11 @@ class IExecutor {
   using task = std::weak_ptr<IExecutable>;
   virtual ~IExecutor(){};
   virtual bool Submit(const std::shared_ptr<IExecutable>& executable, const std::shared_ptr<IExecutable>& ref, bool after=true) = 0;
-  virtual bool Trigger(bool async = false) = 0;  // todo: async=true
+  // Runs the submitted executables in submission order. With async, returns
+  // once the first one is queued and chains the rest from its completion.
+  virtual bool Trigger(bool async = false) = 0;
+  // Blocks until every asynchronous Trigger has finished.
+  virtual void Wait();
   virtual std::shared_ptr<IExecutable> Compile(const std::shared_ptr<Graph>& graph) = 0;
   virtual std::shared_ptr<IDevice> Device() const;
   virtual std::shared_ptr<Context> Contex() const;
@@ -84,6 +103,7 @@ class IExecutor {
   std::vector<task> tasks_;
   std::shared_ptr<IDevice> device_;
   std::shared_ptr<Context> context_;
+  Completion completion_;
 };
 
 class IExecutable : public std::enable_shared_from_this<IExecutable>{
@@ -93,7 +113,19 @@ class IExecutable : public std::enable_shared_from_this<IExecutable>{
   virtual void SetOutput(const std::shared_ptr<ITensorHandle>& th) = 0;
   virtual void GetOutput(const std::vector<std::shared_ptr<ITensorHandle>>& th) = 0;  // for remote
   virtual bool Submit(const std::shared_ptr<IExecutable>& ref, bool after = true) = 0;
-  virtual bool Trigger(bool async = false) = 0;  // todo: async=true
+  // With async, returns once the work is queued on the device; use the
+  // callback or Wait() to learn when it has run. Runs of one executable
+  // share its tensors, wait for a run before triggering it again.
+  virtual bool Trigger(bool async = false) = 0;
+  // Queues the executable and calls done(this) once it has run. The base
+  // version runs synchronously; executors use it to chain executables.
+  // Safe to call from done, it does not wait for room in the device queue.
+  virtual bool Launch(const IDevice::async_callback& done);
+  // Called with this executable from a device worker after every run,
+  // before the executable after it in an executor is queued.
+  virtual void SetCallback(const IDevice::async_callback& cb);
+  // Blocks until every triggered run of this executable has finished.
+  virtual void Wait();
   virtual bool Verify() = 0;
   virtual std::shared_ptr<Graph> NBGraph() const;
   virtual std::shared_ptr<ITensorHandle> AllocateTensor(const TensorSpec& tensor_spec) = 0;
@@ -103,6 +135,8 @@ class IExecutable : public std::enable_shared_from_this<IExecutable>{
   std::weak_ptr<IExecutor> executor_;
   std::shared_ptr<Context> context_;
   std::shared_ptr<Graph> nb_graph_;
+  IDevice::async_callback callback_;
+  Completion completion_;
 };
 
 class ExecutableSet : public IExecutable{
@@ -113,6 +147,7 @@ class ExecutableSet : public IExecutable{
   void GetOutput(const std::vector<std::shared_ptr<ITensorHandle>>& th) override;
   bool Submit(const std::shared_ptr<IExecutable>& ref, bool after = true) override;
   bool Trigger(bool async = false) override;
+  bool Launch(const IDevice::async_callback& done) override;
   bool Verify() override;
   std::shared_ptr<ITensorHandle> AllocateTensor(const TensorSpec& tensor_spec) override;
   std::vector<std::shared_ptr<IExecutable>> Executables() const;
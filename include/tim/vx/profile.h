@@ -0,0 +1,79 @@
+/****************************************************************************
+*
+*    Copyright (c) 2022 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_PROFILE_H_
+#define TIM_VX_PROFILE_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace tim {
+namespace vx {
+
+class Operation;
+
+/// Timing of one operation, collected by Graph::EnableProfiling().
+struct OpProfile {
+  struct Sample {
+    uint64_t start_ns{0};     // offset from the start of the run
+    uint64_t duration_ns{0};  // device time reported by the driver
+  };
+
+  std::shared_ptr<Operation> op;
+  /// Low-level op name, e.g. "CONV2D"
+  std::string name;
+  /// Kernel types the op was instanced with: "EVIS", "CL", "CPU", "VX" or
+  /// "SP", joined by '|' when it is expanded into several kernels.
+  std::string kernel_type;
+  /// Tensor bytes read and written by one run of the op
+  uint64_t input_bytes{0};
+  uint64_t output_bytes{0};
+  /// One sample per profiled Run(), in run order
+  std::vector<Sample> samples;
+};
+
+struct GraphProfile {
+  /// Host wall time of each profiled Run(), since the steady clock epoch
+  struct Run {
+    uint64_t start_ns{0};
+    uint64_t duration_ns{0};
+  };
+
+  std::vector<Run> runs;
+  std::vector<OpProfile> ops;
+
+  /// {"runs": [...], "ops": [{"name", "kernel_type", "input_bytes",
+  /// "output_bytes", "time_ns": [...]}]}
+  std::string ToJson() const;
+  /// Trace Event Format, loadable by chrome://tracing and Perfetto. Each run
+  /// is one event on the host track and its ops are events on the device
+  /// track.
+  std::string ToChromeTrace() const;
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_PROFILE_H_ */
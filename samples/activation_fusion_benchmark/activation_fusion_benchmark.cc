@@ -0,0 +1,138 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/tensor.h"
+#include "tim/transform/activation_fusion.h"
+
+namespace {
+
+constexpr uint32_t kSize = 56;
+constexpr uint32_t kChannels = 32;
+
+// A stack of 1x1 conv -> add(per-channel offset) -> relu blocks on a
+// 56x56x32 float32 feature map, the shape of a MobileNet pointwise stage.
+std::shared_ptr<tim::vx::Graph> BuildGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx, uint32_t blocks,
+    std::vector<std::vector<float>>& constants) {
+  tim::vx::ShapeType shape({kSize, kSize, kChannels, 1});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32,
+                                  {1, 1, kChannels, kChannels},
+                                  tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {kChannels},
+                                tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec offset_spec(tim::vx::DataType::FLOAT32,
+                                  {1, 1, kChannels, 1},
+                                  tim::vx::TensorAttribute::CONSTANT);
+
+  auto graph = ctx->CreateGraph();
+  auto prev = graph->CreateTensor(input_spec);
+  for (uint32_t i = 0; i < blocks; ++i) {
+    constants.emplace_back(kChannels * kChannels, 1.0f / kChannels);
+    auto weight = graph->CreateTensor(weight_spec, constants.back().data());
+    constants.emplace_back(kChannels, 0.0f);
+    auto bias = graph->CreateTensor(bias_spec, constants.back().data());
+    constants.emplace_back(kChannels, -0.5f);
+    auto offset = graph->CreateTensor(offset_spec, constants.back().data());
+
+    auto conv_out = graph->CreateTensor(transient_spec);
+    auto add_out = graph->CreateTensor(transient_spec);
+    auto out = graph->CreateTensor(i + 1 == blocks ? output_spec
+                                                   : transient_spec);
+    graph->CreateOperation<tim::vx::ops::Conv2d>(
+        kChannels, tim::vx::PadType::VALID, std::array<uint32_t, 2>({1, 1}),
+        std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}))
+        ->BindInputs({prev, weight, bias})
+        .BindOutput(conv_out);
+    graph->CreateOperation<tim::vx::ops::Add>()
+        ->BindInputs({conv_out, offset})
+        .BindOutput(add_out);
+    graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(add_out).BindOutput(
+        out);
+    prev = out;
+  }
+  return graph;
+}
+
+double RunsPerSecond(const std::shared_ptr<tim::vx::Graph>& graph,
+                     uint32_t iterations) {
+  auto input = graph->InputsTensor()[0];
+  std::vector<float> data(input->GetSpec().GetElementNum(), 1.0f);
+  input->CopyDataToTensor(data.data(), data.size() * sizeof(float));
+  graph->Run();  // warm up
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < iterations; ++i) {
+    graph->Run();
+  }
+  auto end = std::chrono::steady_clock::now();
+  return iterations / std::chrono::duration<double>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t iterations = 20;
+  if (argc > 1) {
+    iterations = static_cast<uint32_t>(atoi(argv[1]));
+  }
+
+  auto ctx = tim::vx::Context::Create();
+  std::cout << std::setw(8) << "blocks" << std::setw(16) << "unfused(run/s)"
+            << std::setw(14) << "fused(run/s)" << std::setw(16)
+            << "saved(MB/run)" << std::endl;
+  for (uint32_t blocks : {1u, 4u, 16u}) {
+    std::vector<std::vector<float>> constants;
+    auto graph = BuildGraph(ctx, blocks, constants);
+    tim::transform::ActivationFusionReport report;
+    auto fused = tim::transform::FuseActivations(graph, ctx, &report).first;
+    if (!graph->Compile() || !fused->Compile()) {
+      std::cerr << "Compile failed" << std::endl;
+      return 1;
+    }
+    double unfused_rate = RunsPerSecond(graph, iterations);
+    double fused_rate = RunsPerSecond(fused, iterations);
+    std::cout << std::setw(8) << blocks << std::setw(16) << std::fixed
+              << std::setprecision(2) << unfused_rate << std::setw(14)
+              << fused_rate << std::setw(16)
+              << 2.0 * report.saved_bytes / (1024.0 * 1024.0) << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,139 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/platform/device_pool.h"
+#include "tim/vx/platform/native.h"
+
+namespace {
+
+const uint32_t kDepth = 16;
+const tim::vx::ShapeType kShape({64, 64, 16, 1});
+
+// A chain of add/relu pairs, enough device work per request for the
+// dispatch overhead not to dominate.
+std::shared_ptr<tim::vx::Graph> BuildModel(
+    const std::shared_ptr<tim::vx::Context>& ctx) {
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, kShape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, kShape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, kShape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto graph = ctx->CreateGraph();
+  auto input = graph->CreateTensor(input_spec);
+  auto prev = input;
+  for (uint32_t i = 0; i < kDepth; ++i) {
+    auto sum = graph->CreateTensor(transient_spec);
+    graph->CreateOperation<tim::vx::ops::Add>()
+        ->BindInputs({prev, input})
+        .BindOutput(sum);
+    auto out = graph->CreateTensor(i + 1 == kDepth ? output_spec
+                                                   : transient_spec);
+    graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(sum).BindOutput(
+        out);
+    prev = out;
+  }
+  return graph;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int requests = 200;
+  if (argc > 1) {
+    requests = std::max(1, atoi(argv[1]));
+  }
+
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  if (devices.empty()) {
+    std::cout << "No device found." << std::endl;
+    return -1;
+  }
+
+  size_t elements = 1;
+  for (auto d : kShape) {
+    elements *= d;
+  }
+  std::vector<float> input(elements, 1.0f);
+  std::vector<std::vector<float>> outputs(requests,
+                                          std::vector<float>(elements));
+
+  std::cout << std::setw(10) << "devices" << std::setw(14) << "requests/s"
+            << std::setw(10) << "scaling" << "  per device" << std::endl;
+  double single = 0;
+  for (size_t n = 1; n <= devices.size(); ++n) {
+    std::vector<std::shared_ptr<tim::vx::platform::IDevice>> subset(
+        devices.begin(), devices.begin() + n);
+    auto pool = tim::vx::platform::DevicePool::Create(subset);
+    auto model = pool->AddModel(BuildModel);
+
+    // Warm up every device once
+    for (size_t i = 0; i < n; ++i) {
+      pool->Dispatch({model, {input.data()}, {outputs[0].data()}, nullptr});
+    }
+    pool->Wait();
+    auto warm = pool->CompletedPerDevice();
+
+    std::atomic<int> failed(0);
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < requests; ++r) {
+      pool->Dispatch({model, {input.data()}, {outputs[r].data()},
+                      [&failed](bool ok) {
+                        if (!ok) failed++;
+                      }});
+    }
+    pool->Wait();
+    double seconds = std::chrono::duration<double>(
+                         std::chrono::steady_clock::now() - start)
+                         .count();
+
+    double rps = requests / seconds;
+    if (1 == n) {
+      single = rps;
+    }
+    std::cout << std::setw(10) << n << std::setw(14) << std::fixed
+              << std::setprecision(1) << rps << std::setw(10)
+              << std::setprecision(2) << rps / single << " ";
+    auto completed = pool->CompletedPerDevice();
+    for (size_t i = 0; i < completed.size(); ++i) {
+      std::cout << " " << completed[i] - warm[i];
+    }
+    if (failed > 0) {
+      std::cout << "  (" << failed << " failed)";
+    }
+    std::cout << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,97 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+// Build a residual chain t[i + 1] = t[i] + x, every op also consumes the
+// graph input so both the producer and the consumer index are exercised.
+// Returns the build time, and the time of one Fingerprint() call on the
+// finished graph in `fingerprint_ms`.
+double BuildGraph(const std::shared_ptr<tim::vx::Context>& ctx,
+                  uint32_t op_count, double* fingerprint_ms) {
+  tim::vx::ShapeType shape({16, 16, 4, 1});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto start = std::chrono::steady_clock::now();
+  auto graph = ctx->CreateGraph();
+  auto x = graph->CreateTensor(input_spec);
+  auto prev = x;
+  for (uint32_t i = 0; i < op_count; ++i) {
+    auto out = graph->CreateTensor(i + 1 == op_count ? output_spec
+                                                     : transient_spec);
+    graph->CreateOperation<tim::vx::ops::Add>()
+        ->BindInputs({prev, x})
+        .BindOutput(out);
+    prev = out;
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  auto fingerprint_start = std::chrono::steady_clock::now();
+  graph->Fingerprint();
+  auto fingerprint_end = std::chrono::steady_clock::now();
+  *fingerprint_ms = std::chrono::duration<double, std::milli>(
+                        fingerprint_end - fingerprint_start)
+                        .count();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t max_ops = 50000;
+  if (argc > 1) {
+    max_ops = static_cast<uint32_t>(atoi(argv[1]));
+  }
+
+  auto ctx = tim::vx::Context::Create();
+  std::cout << std::setw(10) << "ops" << std::setw(14) << "build(ms)"
+            << std::setw(14) << "us/op" << std::setw(18) << "fingerprint(us)"
+            << std::endl;
+  for (uint32_t op_count : {1000u, 2000u, 5000u, 10000u, 20000u, 50000u}) {
+    if (op_count > max_ops) break;
+    double fingerprint_ms = 0;
+    double ms = BuildGraph(ctx, op_count, &fingerprint_ms);
+    std::cout << std::setw(10) << op_count << std::setw(14) << std::fixed
+              << std::setprecision(2) << ms << std::setw(14)
+              << std::setprecision(3) << ms * 1000.0 / op_count
+              << std::setw(18) << fingerprint_ms * 1000.0 << std::endl;
+  }
+  return 0;
+}
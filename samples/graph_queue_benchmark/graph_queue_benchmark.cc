@@ -0,0 +1,125 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "vip/virtual_device.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+  double items_per_s;
+  double submit_us;   // mean time a producer spends in one submit call
+  size_t rejected;    // TryGraphSubmit calls refused by a full queue
+};
+
+// Every producer pushes callback-only items, so the device workers spend
+// (almost) no time per item and the queue itself is the bottleneck.
+Result Run(uint32_t producers, size_t items, size_t capacity, bool try_submit) {
+  vip::IDevice device(0, capacity);
+  std::atomic<size_t> handled(0);
+  std::atomic<size_t> rejected(0);
+  std::atomic<int64_t> submit_ns(0);
+  auto func = [&handled](const void*) {
+    handled.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  };
+
+  size_t per_producer = items / producers;
+  std::vector<std::thread> threads;
+  auto start = Clock::now();
+  for (uint32_t p = 0; p < producers; ++p) {
+    threads.emplace_back([&, p]() {
+      int64_t spent = 0;
+      for (size_t i = 0; i < per_producer; ++i) {
+        auto priority = static_cast<vip::Priority>((p + i) % vip::kPriorityLevels);
+        auto t0 = Clock::now();
+        if (try_submit) {
+          while (!device.TryGraphSubmit(nullptr, func, nullptr, priority)) {
+            rejected.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+          }
+        } else {
+          device.GraphSubmit(nullptr, func, nullptr, priority);
+        }
+        spent += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     Clock::now() - t0).count();
+      }
+      submit_ns.fetch_add(spent, std::memory_order_relaxed);
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  device.WaitThreadIdle();
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  size_t total = per_producer * producers;
+  if (handled.load() != total) {
+    std::cout << "Lost items: " << total - handled.load() << std::endl;
+  }
+  Result r;
+  r.items_per_s = total / seconds;
+  r.submit_us = submit_ns.load() / 1000.0 / total;
+  r.rejected = rejected.load();
+  return r;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  size_t items = 200000;
+  if (argc > 1) {
+    items = std::max(1, atoi(argv[1]));
+  }
+
+  std::cout << std::setw(10) << "producers" << std::setw(12) << "capacity"
+            << std::setw(16) << "block(item/s)" << std::setw(12)
+            << "submit(us)" << std::setw(16) << "try(item/s)"
+            << std::setw(12) << "rejected" << std::endl;
+  for (size_t capacity : {size_t(16), vip::kDefaultQueueCapacity}) {
+    for (uint32_t producers : {1u, 2u, 4u, 8u, 16u, 32u}) {
+      if (items < producers) {
+        break;
+      }
+      Result block = Run(producers, items, capacity, false);
+      Result fail = Run(producers, items, capacity, true);
+      std::cout << std::setw(10) << producers << std::setw(12) << capacity
+                << std::setw(16) << std::fixed << std::setprecision(0)
+                << block.items_per_s << std::setw(12) << std::setprecision(3)
+                << block.submit_us << std::setw(16) << std::setprecision(0)
+                << fail.items_per_s << std::setw(12) << fail.rejected
+                << std::endl;
+    }
+  }
+  return 0;
+}
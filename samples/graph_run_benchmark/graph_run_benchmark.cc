@@ -0,0 +1,206 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+constexpr size_t kAlignment = 64;
+
+struct AlignedFree {
+  void operator()(void* ptr) const { free(ptr); }
+};
+using Buffer = std::unique_ptr<uint8_t, AlignedFree>;
+
+Buffer AllocFrame(size_t bytes) {
+  size_t padded = (bytes + kAlignment - 1) & ~(kAlignment - 1);
+  return Buffer(static_cast<uint8_t*>(aligned_alloc(kAlignment, padded)));
+}
+
+// out = frame + bias on a HWC uint8 frame, the shape of a camera pipeline
+// pre-processing step.
+struct FrameGraph {
+  std::shared_ptr<tim::vx::Graph> graph;
+  std::shared_ptr<tim::vx::Tensor> frame;
+  std::shared_ptr<tim::vx::Tensor> bias;
+  std::shared_ptr<tim::vx::Tensor> output;
+  size_t bytes;
+};
+
+FrameGraph BuildFrameGraph(const std::shared_ptr<tim::vx::Context>& ctx,
+                           uint32_t width, uint32_t height) {
+  tim::vx::ShapeType shape({3, width, height, 1});
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 1.0f, 0);
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8, shape,
+                                 tim::vx::TensorAttribute::INPUT, quant);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8, shape,
+                                  tim::vx::TensorAttribute::OUTPUT, quant);
+
+  FrameGraph fg;
+  fg.graph = ctx->CreateGraph();
+  fg.frame = fg.graph->CreateTensor(input_spec);
+  fg.bias = fg.graph->CreateTensor(input_spec);
+  fg.output = fg.graph->CreateTensor(output_spec);
+  fg.graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs({fg.frame, fg.bias})
+      .BindOutput(fg.output);
+  fg.bytes = input_spec.GetByteSize();
+  return fg;
+}
+
+// Copy path: CopyDataToTensor + Run() + CopyDataFromTensor per request.
+double RunCopy(FrameGraph& fg, std::vector<Buffer>& frames, Buffer& bias,
+               Buffer& output, int iterations) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    fg.frame->CopyDataToTensor(frames[i % frames.size()].get(), fg.bytes);
+    fg.bias->CopyDataToTensor(bias.get(), fg.bytes);
+    fg.graph->Run();
+    fg.output->CopyDataFromTensor(output.get());
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// Bind path: user buffers are swapped in as tensor handles.
+double RunBind(FrameGraph& fg, std::vector<Buffer>& frames, Buffer& bias,
+               Buffer& output, int iterations) {
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    fg.graph->Run({frames[i % frames.size()].get(), bias.get()},
+                  {output.get()});
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(end - start).count();
+}
+
+// Per-run latency of a tiny residual chain, where the graph bookkeeping
+// done by every Run is comparable to the work done on the device.
+double RunLatency(const std::shared_ptr<tim::vx::Context>& ctx,
+                  uint32_t op_count, int iterations, bool bind) {
+  tim::vx::ShapeType shape({16});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto graph = ctx->CreateGraph();
+  auto x = graph->CreateTensor(input_spec);
+  auto prev = x;
+  for (uint32_t i = 0; i < op_count; ++i) {
+    auto out = graph->CreateTensor(i + 1 == op_count ? output_spec
+                                                     : transient_spec);
+    graph->CreateOperation<tim::vx::ops::Add>()
+        ->BindInputs({prev, x})
+        .BindOutput(out);
+    prev = out;
+  }
+  if (!graph->Compile()) {
+    return -1.0;
+  }
+
+  auto in = AllocFrame(input_spec.GetByteSize());
+  auto out = AllocFrame(output_spec.GetByteSize());
+  memset(in.get(), 0, input_spec.GetByteSize());
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    if (bind) {
+      graph->Run({in.get()}, {out.get()});
+    } else {
+      graph->Run();
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::micro>(end - start).count() /
+         iterations;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int iterations = 20;
+  if (argc > 1) {
+    iterations = atoi(argv[1]);
+  }
+
+  auto ctx = tim::vx::Context::Create();
+  std::cout << std::setw(12) << "frame" << std::setw(10) << "MB"
+            << std::setw(14) << "copy(MB/s)" << std::setw(14) << "bind(MB/s)"
+            << std::endl;
+  const std::vector<std::pair<uint32_t, uint32_t>> resolutions = {
+      {640, 480}, {1280, 720}, {1920, 1080}, {3840, 2160}};
+  for (auto& res : resolutions) {
+    auto fg = BuildFrameGraph(ctx, res.first, res.second);
+    if (!fg.graph->Compile()) {
+      std::cout << "Compile graph fail." << std::endl;
+      return -1;
+    }
+
+    // Rotate through a few frames like a capture ring buffer would
+    std::vector<Buffer> frames;
+    for (int i = 0; i < 3; ++i) {
+      frames.push_back(AllocFrame(fg.bytes));
+      memset(frames.back().get(), i, fg.bytes);
+    }
+    auto bias = AllocFrame(fg.bytes);
+    memset(bias.get(), 1, fg.bytes);
+    auto output = AllocFrame(fg.bytes);
+
+    double copy_s = RunCopy(fg, frames, bias, output, iterations);
+    double bind_s = RunBind(fg, frames, bias, output, iterations);
+
+    // Every request moves two input frames and one output frame
+    double mb = 3.0 * fg.bytes * iterations / (1024.0 * 1024.0);
+    std::cout << std::setw(6) << res.first << "x" << std::setw(5)
+              << res.second << std::setw(10) << std::fixed
+              << std::setprecision(2) << fg.bytes / (1024.0 * 1024.0)
+              << std::setw(14) << mb / copy_s << std::setw(14) << mb / bind_s
+              << std::endl;
+  }
+
+  std::cout << std::endl
+            << std::setw(12) << "ops" << std::setw(14) << "run(us)"
+            << std::setw(14) << "bind(us)" << std::endl;
+  for (uint32_t op_count : {1u, 16u, 64u, 256u}) {
+    int runs = iterations * 50;
+    std::cout << std::setw(12) << op_count << std::setw(14) << std::fixed
+              << std::setprecision(2)
+              << RunLatency(ctx, op_count, runs, false) << std::setw(14)
+              << RunLatency(ctx, op_count, runs, true) << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,113 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/tensor.h"
+#include "tim/transform/layout_inference.h"
+#ifdef ENABLE_BATCH_FUSE
+#include "tim/fuse/batch_fuse.h"
+#endif
+
+namespace {
+
+// Alternate t[i + 1] = t[i] + x and t[i + 1] = relu(t[i]), the adds keep
+// the graph input alive across the whole chain so every op has a consumer
+// list to walk.
+std::shared_ptr<tim::vx::Graph> BuildGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx, uint32_t op_count) {
+  tim::vx::ShapeType shape({4, 8, 8, 4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto graph = ctx->CreateGraph();
+  auto x = graph->CreateTensor(input_spec);
+  auto prev = x;
+  for (uint32_t i = 0; i < op_count; ++i) {
+    auto out = graph->CreateTensor(i + 1 == op_count ? output_spec
+                                                     : transient_spec);
+    if (i % 2) {
+      graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(prev).BindOutput(
+          out);
+    } else {
+      graph->CreateOperation<tim::vx::ops::Add>()
+          ->BindInputs({prev, x})
+          .BindOutput(out);
+    }
+    prev = out;
+  }
+  return graph;
+}
+
+template <typename F>
+double TimeMs(F&& f) {
+  auto start = std::chrono::steady_clock::now();
+  f();
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t max_ops = 10000;
+  if (argc > 1) {
+    max_ops = static_cast<uint32_t>(atoi(argv[1]));
+  }
+
+  auto ctx = tim::vx::Context::Create();
+  std::cout << std::setw(10) << "ops" << std::setw(16) << "layout(ms)"
+            << std::setw(14) << "us/op" << std::setw(16) << "batchfuse(ms)"
+            << std::endl;
+  for (uint32_t op_count : {1000u, 2000u, 5000u, 10000u}) {
+    if (op_count > max_ops) break;
+    auto graph = BuildGraph(ctx, op_count);
+    std::shared_ptr<tim::vx::Graph> infer_graph;
+    double layout_ms = TimeMs([&]() {
+      infer_graph = tim::transform::LayoutInference(graph, ctx).first;
+    });
+    double fuse_ms = 0;
+#ifdef ENABLE_BATCH_FUSE
+    fuse_ms = TimeMs([&]() { tim::fuse::BatchFuse(infer_graph, ctx, 4); });
+#endif
+    std::cout << std::setw(10) << op_count << std::setw(16) << std::fixed
+              << std::setprecision(2) << layout_ms << std::setw(14)
+              << std::setprecision(3) << layout_ms * 1000.0 / op_count
+              << std::setw(16) << std::setprecision(2) << fuse_ms
+              << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,166 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "vsi_nn_pub.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(const Clock::time_point& start) {
+  return std::chrono::duration<double, std::milli>(Clock::now() - start)
+      .count();
+}
+
+vsi_nn_tensor_id_t AddTensor(vsi_nn_graph_t* graph, bool is_virtual) {
+  vsi_nn_tensor_attr_t attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.dim_num = 4;
+  attr.size[0] = 8;
+  attr.size[1] = 8;
+  attr.size[2] = 4;
+  attr.size[3] = 1;
+  attr.vtl = is_virtual;
+  if (is_virtual) {
+    attr.dim_num = VSI_NN_DIM_AUTO;
+  }
+  attr.dtype.vx_type = VSI_NN_TYPE_FLOAT32;
+  attr.dtype.qnt_type = VSI_NN_QNT_TYPE_NONE;
+  return vsi_nn_AddTensor(graph, VSI_NN_TENSOR_ID_AUTO, &attr, NULL);
+}
+
+// Chain of relu nodes: every node produces the input of the next one.
+vsi_nn_graph_t* BuildChain(vsi_nn_context_t ctx, uint32_t node_count) {
+  vsi_nn_graph_t* graph = vsi_nn_CreateGraph(ctx, 0, 0);
+  vsi_nn_tensor_id_t input = AddTensor(graph, false);
+  vsi_nn_tensor_id_t prev = input;
+  for (uint32_t i = 0; i < node_count; ++i) {
+    vsi_nn_tensor_id_t out = AddTensor(graph, i + 1 != node_count);
+    vsi_nn_node_t* node = vsi_nn_AddNode(graph, VSI_NN_OP_RELU, 1, 1, NULL);
+    node->input.tensors[0] = prev;
+    node->output.tensors[0] = out;
+    prev = out;
+  }
+  vsi_nn_SetGraphInputs(graph, &input, 1);
+  vsi_nn_SetGraphOutputs(graph, &prev, 1);
+  return graph;
+}
+
+// kWidth parallel relu chains fed by one input and added round-robin,
+// so consecutive node ids never depend on each other.
+vsi_nn_graph_t* BuildWide(vsi_nn_context_t ctx, uint32_t node_count) {
+  const uint32_t kWidth = 64;
+  vsi_nn_graph_t* graph = vsi_nn_CreateGraph(ctx, 0, 0);
+  vsi_nn_tensor_id_t input = AddTensor(graph, false);
+  uint32_t depth = (node_count + kWidth - 1) / kWidth;
+  std::vector<vsi_nn_tensor_id_t> tails(kWidth, input);
+  for (uint32_t d = 0; d < depth; ++d) {
+    for (uint32_t w = 0; w < kWidth; ++w) {
+      vsi_nn_tensor_id_t out = AddTensor(graph, d + 1 != depth);
+      vsi_nn_node_t* node = vsi_nn_AddNode(graph, VSI_NN_OP_RELU, 1, 1, NULL);
+      node->input.tensors[0] = tails[w];
+      node->output.tensors[0] = out;
+      tails[w] = out;
+    }
+  }
+  vsi_nn_SetGraphInputs(graph, &input, 1);
+  vsi_nn_SetGraphOutputs(graph, tails.data(), kWidth);
+  return graph;
+}
+
+void RunCase(vsi_nn_context_t ctx, bool wide, uint32_t node_count) {
+  auto start = Clock::now();
+  vsi_nn_graph_t* graph =
+      wide ? BuildWide(ctx, node_count) : BuildChain(ctx, node_count);
+  double build_ms = ElapsedMs(start);
+
+  // Sweep every tensor id the way setup and the optimization passes do.
+  start = Clock::now();
+  uint32_t found = 0;
+  for (uint32_t i = 0; i < graph->tensor_num; ++i) {
+    found += (NULL != vsi_nn_GetTensor(graph, i)) ? 1 : 0;
+  }
+  for (uint32_t i = 0; i < graph->node_num; ++i) {
+    found += (NULL != vsi_nn_GetNode(graph, i)) ? 1 : 0;
+  }
+  double lookup_ms = ElapsedMs(start);
+
+  start = Clock::now();
+  vsi_nn_node_id_t* sorted = vsi_nn_SortGraphNode(graph);
+  double sort_ms = ElapsedMs(start);
+  bool sorted_ok = (NULL != sorted);
+  free(sorted);
+
+  start = Clock::now();
+  vsi_status status = vsi_nn_SetupGraph(graph, TRUE);
+  double setup_ms = ElapsedMs(start);
+
+  std::cout << std::setw(8) << (wide ? "wide" : "chain") << std::setw(10)
+            << graph->tensor_num << std::setw(10) << graph->node_num
+            << std::fixed << std::setprecision(2) << std::setw(12) << build_ms
+            << std::setw(12) << lookup_ms << std::setw(12) << sort_ms
+            << std::setw(12) << setup_ms
+            << (sorted_ok ? "" : "  (sort failed)")
+            << (VSI_SUCCESS == status ? "" : "  (setup failed)")
+            << (found == graph->tensor_num + graph->node_num
+                    ? ""
+                    : "  (lookup mismatch)")
+            << std::endl;
+  vsi_nn_ReleaseGraph(&graph);
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  uint32_t max_nodes = 20000;
+  if (argc > 1) {
+    max_nodes = static_cast<uint32_t>(atoi(argv[1]));
+  }
+
+  vsi_nn_context_t ctx = vsi_nn_CreateContext();
+  if (NULL == ctx) {
+    std::cout << "Create context fail." << std::endl;
+    return -1;
+  }
+
+  std::cout << std::setw(8) << "graph" << std::setw(10) << "tensors"
+            << std::setw(10) << "nodes" << std::setw(12) << "build(ms)"
+            << std::setw(12) << "lookup(ms)" << std::setw(12) << "sort(ms)"
+            << std::setw(12) << "setup(ms)" << std::endl;
+  for (bool wide : {false, true}) {
+    for (uint32_t node_count : {1000u, 5000u, 10000u, 20000u}) {
+      if (node_count > max_nodes) break;
+      RunCase(ctx, wide, node_count);
+    }
+  }
+
+  vsi_nn_ReleaseContext(&ctx);
+  return 0;
+}
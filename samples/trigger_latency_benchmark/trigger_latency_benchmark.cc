@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/platform/native.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+// x + x on a tiny tensor, so the measured time is dominated by the
+// submit/trigger/wait round trip through the device rather than the kernel.
+std::shared_ptr<tim::vx::Graph> BuildGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx,
+    tim::vx::TensorSpec& input_spec, tim::vx::TensorSpec& output_spec) {
+  tim::vx::ShapeType shape({16});
+  input_spec = tim::vx::TensorSpec(tim::vx::DataType::FLOAT32, shape,
+                                   tim::vx::TensorAttribute::INPUT);
+  output_spec = tim::vx::TensorSpec(tim::vx::DataType::FLOAT32, shape,
+                                    tim::vx::TensorAttribute::OUTPUT);
+  auto graph = ctx->CreateGraph();
+  auto input = graph->CreateTensor(input_spec);
+  auto output = graph->CreateTensor(output_spec);
+  graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs({input, input})
+      .BindOutput(output);
+  return graph;
+}
+
+double Percentile(const std::vector<double>& sorted, double p) {
+  size_t idx = static_cast<size_t>(p * (sorted.size() - 1));
+  return sorted[idx];
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  int iterations = 1000;
+  if (argc > 1) {
+    iterations = std::max(1, atoi(argv[1]));
+  }
+
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  if (devices.empty()) {
+    std::cout << "No device found." << std::endl;
+    return -1;
+  }
+
+  auto ctx = tim::vx::Context::Create();
+  tim::vx::TensorSpec input_spec, output_spec;
+  auto graph = BuildGraph(ctx, input_spec, output_spec);
+  auto executor =
+      std::make_shared<tim::vx::platform::NativeExecutor>(devices[0], ctx);
+  auto executable = executor->Compile(graph);
+  auto input = executable->AllocateTensor(input_spec);
+  auto output = executable->AllocateTensor(output_spec);
+  executable->SetInput(input);
+  executable->SetOutput(output);
+
+  std::vector<float> in_data(input_spec.GetElementNum(), 1.0f);
+  std::vector<float> out_data(output_spec.GetElementNum());
+  input->CopyDataToTensor(in_data.data(), input_spec.GetByteSize());
+
+  // Warm up, the first trigger pays for NBG loading on the device
+  for (int i = 0; i < 10; ++i) {
+    executable->Trigger();
+  }
+
+  std::vector<double> latency_us;
+  latency_us.reserve(iterations);
+  auto total_start = std::chrono::steady_clock::now();
+  for (int i = 0; i < iterations; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    executable->Trigger();
+    auto end = std::chrono::steady_clock::now();
+    latency_us.push_back(
+        std::chrono::duration<double, std::micro>(end - start).count());
+  }
+  auto total_end = std::chrono::steady_clock::now();
+  output->CopyDataFromTensor(out_data.data());
+
+  std::sort(latency_us.begin(), latency_us.end());
+  double total_s =
+      std::chrono::duration<double>(total_end - total_start).count();
+  std::cout << std::fixed << std::setprecision(2)
+            << "triggers:   " << iterations << std::endl
+            << "mean(us):   " << total_s * 1e6 / iterations << std::endl
+            << "p50(us):    " << Percentile(latency_us, 0.50) << std::endl
+            << "p99(us):    " << Percentile(latency_us, 0.99) << std::endl
+            << "max(us):    " << latency_us.back() << std::endl
+            << "trigger/s:  " << iterations / total_s << std::endl;
+  return 0;
+}
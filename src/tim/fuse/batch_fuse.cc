@@ -24,18 +24,14 @@ namespace fuse {
 namespace batch_fuse_impl {
 
 void BatchFuseContext::MarkVisited(const std::shared_ptr<vx::Operation>& op) {
-  if (visited_op_.end() !=
-      std::find(visited_op_.begin(), visited_op_.end(), op)) {
+  if (!visited_op_.insert(op).second) {
     VSILOGW("The operation has been mark as visited.");
-  } else {
-    visited_op_.push_back(op);
   }
 }
 
 bool BatchFuseContext::IsVisited(
     const std::shared_ptr<vx::Operation>& op) const {
-  return (visited_op_.end() !=
-          std::find(visited_op_.begin(), visited_op_.end(), op));
+  return visited_op_.count(op) != 0;
 }
 
 bool BatchFuseContext::IsReadyForBatchFuse(
@@ -1,5 +1,7 @@
 #ifndef TIM_VX_BATCH_FUSE_CONTEXT_H_
 #define TIM_VX_BATCH_FUSE_CONTEXT_H_
+#include <unordered_set>
+
 #include "tim/fuse/batch_fuse.h"
 
 namespace tim {
@@ -127,7 +129,7 @@ class BatchFuseContext {
   std::shared_ptr<vx::Graph>&
       clone_batch_graph_;  //cloned from src_graph which can set fake batch
 
-  std::vector<std::shared_ptr<vx::Operation>> visited_op_;
+  std::unordered_set<std::shared_ptr<vx::Operation>> visited_op_;
 
   // src graph is relatively, layout infered graph is the source graph of clone graph
   // clone graph is the source graph of batch fuse graph
@@ -0,0 +1,230 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/transform/activation_fusion.h"
+
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "graph_utils.h"
+#include "builtin_op_impl.h"
+#include "graph_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+struct FusionPlan {
+  // Output of the last op merged into the head op
+  std::shared_ptr<vx::Tensor> tail;
+  // Replacement bias, empty to keep the original one
+  std::vector<float> bias;
+  bool relu{false};
+};
+
+bool IsFloat32(const std::shared_ptr<vx::Tensor>& t) {
+  return t->GetDataType() == vx::DataType::FLOAT32;
+}
+
+// The only operation reading `t`, nullptr if the value is needed elsewhere
+std::shared_ptr<vx::Operation> SoleConsumer(
+    const std::shared_ptr<vx::Graph>& graph,
+    const std::shared_ptr<vx::Tensor>& t) {
+  if (t->GetSpec().attr_ & vx::TensorAttribute::OUTPUT) {
+    return nullptr;
+  }
+  auto consumers = graph->GetConsumersOp(t);
+  return consumers.size() == 1 ? consumers[0] : nullptr;
+}
+
+uint32_t ChannelAxis(const std::shared_ptr<vx::Operation>& op) {
+  if (op->impl()->kind_ == VSI_NN_OP_CONV2D &&
+      op->impl()->layout_ != vx::DataLayout::CWHN) {
+    return 2;
+  }
+  return 0;
+}
+
+// Whether `c` holds one value per channel of `out` along `axis`
+bool IsPerChannel(const std::shared_ptr<vx::Tensor>& c,
+                  const std::shared_ptr<vx::Tensor>& out, uint32_t axis) {
+  if (!c->IsConstTensor() || !c->GetDataRef() || !IsFloat32(c)) {
+    return false;
+  }
+  auto shape = c->GetShape();
+  auto out_shape = out->GetShape();
+  if (shape.size() == 1) {
+    return axis == 0 && shape[0] == out_shape[0];
+  }
+  if (shape.size() != out_shape.size()) {
+    return false;
+  }
+  for (uint32_t i = 0; i < shape.size(); i++) {
+    if (shape[i] != (i == axis ? out_shape[i] : 1)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::vector<float> BiasData(const std::shared_ptr<vx::Tensor>& bias,
+                            uint32_t channels) {
+  std::vector<float> data(channels, 0.0f);
+  if (bias) {
+    memcpy(data.data(), bias->GetDataRef(), channels * sizeof(float));
+  }
+  return data;
+}
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+FuseActivations(const std::shared_ptr<vx::Graph>& src_graph,
+                std::shared_ptr<vx::Context>& ctx,
+                ActivationFusionReport* report) {
+  auto ops = graph_utils::SortOperations(src_graph);
+  std::unordered_map<const vx::Operation*, FusionPlan> plans;
+  std::unordered_set<const vx::Operation*> absorbed;
+  ActivationFusionReport fusion;
+
+  for (const auto& op : ops) {
+    auto kind = op->impl()->kind_;
+    if ((kind != VSI_NN_OP_CONV2D && kind != VSI_NN_OP_FCL2) ||
+        !op->impl()->node() || absorbed.count(op.get())) {
+      continue;
+    }
+    const auto& inputs = op->impl()->InputsTensor();
+    auto out = op->impl()->OutputsTensor()[0];
+    // The fused ops build their weights at compile time
+    if (inputs.size() < 2 || !inputs[1]->IsConstTensor()) {
+      continue;
+    }
+    auto bias = inputs.size() > 2 ? inputs[2] : nullptr;
+    bool float_bias = !bias || (bias->IsConstTensor() && bias->GetDataRef() &&
+                                IsFloat32(bias));
+    uint32_t axis = ChannelAxis(op);
+    uint32_t channels = out->GetShape()[axis];
+    FusionPlan plan;
+    plan.tail = out;
+
+    auto next = SoleConsumer(src_graph, plan.tail);
+    if (next && next->impl()->kind_ == VSI_NN_OP_ADD && IsFloat32(out) &&
+        float_bias) {
+      const auto& add_inputs = next->impl()->InputsTensor();
+      auto addend = add_inputs[0] == out ? add_inputs.back() : add_inputs[0];
+      if (add_inputs.size() == 2 && IsPerChannel(addend, out, axis)) {
+        plan.bias = BiasData(bias, channels);
+        auto addend_data = static_cast<const float*>(addend->GetDataRef());
+        for (uint32_t i = 0; i < channels; i++) {
+          plan.bias[i] += addend_data[i];
+        }
+        absorbed.insert(next.get());
+        fusion.fused_biases++;
+        fusion.saved_bytes += plan.tail->GetSpec().GetByteSize();
+        plan.tail = next->impl()->OutputsTensor()[0];
+      }
+    }
+
+    next = SoleConsumer(src_graph, plan.tail);
+    bool has_bias = bias || !plan.bias.empty();
+    // FCL_RELU reads 2D inputs only
+    bool fc_shape_ok =
+        kind != VSI_NN_OP_FCL2 || inputs[0]->GetShape().size() <= 2;
+    if (next && next->impl()->kind_ == VSI_NN_OP_RELU && fc_shape_ok &&
+        (has_bias || IsFloat32(out))) {
+      if (!has_bias) {
+        // The fused ops need a bias tensor
+        plan.bias = BiasData(nullptr, channels);
+      }
+      absorbed.insert(next.get());
+      plan.relu = true;
+      fusion.fused_activations++;
+      fusion.saved_bytes += plan.tail->GetSpec().GetByteSize();
+      plan.tail = next->impl()->OutputsTensor()[0];
+    }
+
+    if (plan.tail != out) {
+      plans[op.get()] = plan;
+    }
+  }
+
+  std::shared_ptr<vx::Graph> dst_graph = ctx->CreateGraph();
+  graph_utils::TensorMap tensor_map;
+  for (const auto& op : ops) {
+    if (absorbed.count(op.get())) {
+      continue;
+    }
+    auto plan_it = plans.find(op.get());
+    if (plan_it == plans.end()) {
+      graph_utils::CloneOperation(op, dst_graph, tensor_map);
+      continue;
+    }
+    const auto& plan = plan_it->second;
+    const auto& inputs = op->impl()->InputsTensor();
+    auto fused_op = op->Clone(dst_graph);
+    fused_op->BindInput(graph_utils::MapTensor(inputs[0], dst_graph, tensor_map));
+    fused_op->BindInput(graph_utils::MapTensor(inputs[1], dst_graph, tensor_map));
+    if (!plan.bias.empty()) {
+      vx::TensorSpec bias_spec(vx::DataType::FLOAT32,
+                               {static_cast<uint32_t>(plan.bias.size())},
+                               vx::TensorAttribute::CONSTANT);
+      std::vector<uint8_t> bias_data(plan.bias.size() * sizeof(float));
+      memcpy(bias_data.data(), plan.bias.data(), bias_data.size());
+      fused_op->BindInput(std::static_pointer_cast<vx::GraphImpl>(dst_graph)
+                              ->CreateOwnedTensor(bias_spec,
+                                                  std::move(bias_data)));
+    } else if (inputs.size() > 2) {
+      fused_op->BindInput(
+          graph_utils::MapTensor(inputs[2], dst_graph, tensor_map));
+    }
+    fused_op->BindOutput(
+        graph_utils::MapTensor(plan.tail, dst_graph, tensor_map));
+
+    auto node = fused_op->impl()->node();
+    node->vx_param = op->impl()->node()->vx_param;
+    if (plan.relu) {
+      int32_t fused_kind = op->impl()->kind_ == VSI_NN_OP_CONV2D
+                               ? VSI_NN_OP_CONV_RELU
+                               : VSI_NN_OP_FCL_RELU;
+      if (fused_kind == VSI_NN_OP_FCL_RELU) {
+        node->nn_param.fcl.weights = plan.tail->GetShape()[0];
+      }
+      node->op = fused_kind;
+      node->vx_param.has_relu = TRUE;
+      fused_op->impl()->kind_ = fused_kind;
+    }
+  }
+  if (report) {
+    *report = fusion;
+  }
+
+  return std::make_pair(dst_graph,
+                        graph_utils::GraphIoMap(src_graph, tensor_map));
+}
+
+}  // namespace transform
+}  // namespace tim
@@ -0,0 +1,157 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops.h"
+#include "tim/transform/activation_fusion.h"
+
+#include "gtest/gtest.h"
+
+namespace {
+std::vector<float> RunGraph(const std::shared_ptr<tim::vx::Graph>& graph,
+                            const std::shared_ptr<tim::vx::Tensor>& input,
+                            const std::shared_ptr<tim::vx::Tensor>& output,
+                            const std::vector<float>& in_data) {
+  EXPECT_TRUE(graph->Compile());
+  input->CopyDataToTensor(in_data.data(), in_data.size() * sizeof(float));
+  EXPECT_TRUE(graph->Run());
+  std::vector<float> out_data(output->GetSpec().GetElementNum());
+  EXPECT_TRUE(output->CopyDataFromTensor(out_data.data()));
+  return out_data;
+}
+
+void ExpectNear(const std::vector<float>& a, const std::vector<float>& b) {
+  ASSERT_EQ(a.size(), b.size());
+  for (size_t i = 0; i < a.size(); i++) {
+    EXPECT_NEAR(a[i], b[i], 1e-4f) << "at " << i;
+  }
+}
+}  // namespace
+
+TEST(FuseActivations, conv2d_bias_relu) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType in_shape({3, 3, 2, 1});
+  tim::vx::ShapeType weight_shape({1, 1, 2, 2});
+  tim::vx::ShapeType channel_shape({1, 1, 2, 1});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, in_shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32, weight_shape,
+                                  tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {2},
+                                tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec addend_spec(tim::vx::DataType::FLOAT32, channel_shape,
+                                  tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, in_shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, in_shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  std::vector<float> weight_data = {1.0f, -1.0f, 0.5f, 2.0f};
+  std::vector<float> bias_data = {0.25f, -0.5f};
+  std::vector<float> addend_data = {-1.0f, 0.75f};
+  auto input = src_graph->CreateTensor(input_spec);
+  auto weight = src_graph->CreateTensor(weight_spec, weight_data.data());
+  auto bias = src_graph->CreateTensor(bias_spec, bias_data.data());
+  auto addend = src_graph->CreateTensor(addend_spec, addend_data.data());
+  auto conv_out = src_graph->CreateTensor(transient_spec);
+  auto add_out = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+      2, tim::vx::PadType::VALID, std::array<uint32_t, 2>({1, 1}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}))
+      ->BindInputs({input, weight, bias}).BindOutput(conv_out);
+  src_graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs({conv_out, addend}).BindOutput(add_out);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()
+      ->BindInput(add_out).BindOutput(output);
+
+  tim::transform::ActivationFusionReport report;
+  auto transform = tim::transform::FuseActivations(src_graph, ctx, &report);
+  EXPECT_EQ(report.fused_activations, 1);
+  EXPECT_EQ(report.fused_biases, 1);
+  EXPECT_EQ(report.saved_bytes, 2 * 18 * sizeof(float));
+
+  std::vector<float> in_data(18);
+  for (size_t i = 0; i < in_data.size(); i++) {
+    in_data[i] = static_cast<float>(i % 7) - 3.0f;
+  }
+  auto expect_output = RunGraph(src_graph, input, output, in_data);
+  auto fused_output = RunGraph(transform.first, transform.second[input],
+                               transform.second[output], in_data);
+  ExpectNear(fused_output, expect_output);
+}
+
+TEST(FuseActivations, fullyconnected_relu) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {2, 2},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32, {2, 3},
+                                  tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {3},
+                                tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {3, 2},
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {3, 2},
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  std::vector<float> weight_data = {-3, 3, 2, 1, 0, -4};
+  std::vector<float> bias_data = {0.1f, 0.4f, 0.6f};
+  auto input = src_graph->CreateTensor(input_spec);
+  auto weight = src_graph->CreateTensor(weight_spec, weight_data.data());
+  auto bias = src_graph->CreateTensor(bias_spec, bias_data.data());
+  auto fc_out = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  src_graph->CreateOperation<tim::vx::ops::FullyConnected>(0, 3)
+      ->BindInputs({input, weight, bias}).BindOutput(fc_out);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()
+      ->BindInput(fc_out).BindOutput(output);
+
+  tim::transform::ActivationFusionReport report;
+  auto transform = tim::transform::FuseActivations(src_graph, ctx, &report);
+  EXPECT_EQ(report.fused_activations, 1);
+  EXPECT_EQ(report.fused_biases, 0);
+
+  std::vector<float> in_data = {1, 4, 2, 6};
+  auto expect_output = RunGraph(src_graph, input, output, in_data);
+  auto fused_output = RunGraph(transform.first, transform.second[input],
+                               transform.second[output], in_data);
+  ExpectNear(fused_output, expect_output);
+}
+
+TEST(FuseActivations, keep_shared_intermediate) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {2, 2},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32, {2, 3},
+                                  tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {3},
+                                tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {3, 2},
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  std::vector<float> weight_data = {-3, 3, 2, 1, 0, -4};
+  std::vector<float> bias_data = {0.1f, 0.4f, 0.6f};
+  auto input = src_graph->CreateTensor(input_spec);
+  auto weight = src_graph->CreateTensor(weight_spec, weight_data.data());
+  auto bias = src_graph->CreateTensor(bias_spec, bias_data.data());
+  auto fc_out = src_graph->CreateTensor(output_spec);
+  auto relu_out = src_graph->CreateTensor(output_spec);
+
+  // The pre-activation value is a graph output too
+  src_graph->CreateOperation<tim::vx::ops::FullyConnected>(0, 3)
+      ->BindInputs({input, weight, bias}).BindOutput(fc_out);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()
+      ->BindInput(fc_out).BindOutput(relu_out);
+
+  tim::transform::ActivationFusionReport report;
+  auto transform = tim::transform::FuseActivations(src_graph, ctx, &report);
+  EXPECT_EQ(report.fused_activations, 0);
+  EXPECT_EQ(report.saved_bytes, 0);
+  EXPECT_TRUE(transform.first->Compile());
+}
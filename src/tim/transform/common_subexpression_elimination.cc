@@ -0,0 +1,146 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/transform/common_subexpression_elimination.h"
+
+#include <string>
+#include <unordered_map>
+
+#include "graph_utils.h"
+#include "builtin_op_impl.h"
+#include "param_utils.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+
+template <typename T>
+void Append(std::string& key, const T& value) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void Append(std::string& key, const T* data, size_t count) {
+  Append(key, count);
+  if (count > 0) {
+    key.append(reinterpret_cast<const char*>(data), count * sizeof(T));
+  }
+}
+
+/// nn_param with the per-node state left out and the arrays tim-vx ops
+/// point at appended. Pointers of other ops stay, so such ops never compare
+/// equal.
+void AppendParam(std::string& key, const vsi_nn_node_t* node) {
+  for (const auto& array : vx::ParamArrays(node)) {
+    Append(key, static_cast<const char*>(array.data), array.bytes);
+  }
+  Append(key, vx::ComparableParam(node));
+  Append(key, node->vx_param);
+}
+
+void AppendSpec(std::string& key, const vx::TensorSpec& spec) {
+  Append(key, spec.datatype_);
+  Append(key, spec.shape_.data(), spec.shape_.size());
+  const vx::Quantization& quant = spec.quantization_;
+  Append(key, quant.Type());
+  Append(key, quant.ChannelDim());
+  Append(key, quant.Scales().data(), quant.Scales().size());
+  Append(key, quant.ZeroPoints().data(), quant.ZeroPoints().size());
+}
+
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+EliminateCommonSubexpressions(const std::shared_ptr<vx::Graph>& src_graph,
+                              std::shared_ptr<vx::Context>& ctx,
+                              CommonSubexpressionReport* report) {
+  auto ops = graph_utils::SortOperations(src_graph);
+
+  std::shared_ptr<vx::Graph> dst_graph = ctx->CreateGraph();
+  graph_utils::TensorMap tensor_map;
+  CommonSubexpressionReport elimination;
+  std::unordered_map<std::string, std::shared_ptr<vx::Operation>> computed;
+  for (const auto& op : ops) {
+    const auto& impl = op->impl();
+    vsi_nn_node_t* node = impl->node();
+    bool mergeable = node && !impl->InputsTensor().empty() &&
+                     node->op != VSI_NN_OP_RANDOM_MULTINOMIAL;
+    for (const auto& t : impl->OutputsTensor()) {
+      if (t->GetSpec().attr_ & vx::TensorAttribute::OUTPUT) {
+        mergeable = false;
+      }
+    }
+    if (!mergeable) {
+      graph_utils::CloneOperation(op, dst_graph, tensor_map);
+      continue;
+    }
+
+    // Inputs are keyed by the tensors they map to, so the readers of merged
+    // duplicates become duplicates in turn. Placeholders all look the same.
+    std::string key;
+    Append(key, impl->kind_);
+    Append(key, impl->layout_);
+    AppendParam(key, node);
+    for (const auto& t : impl->InputsTensor()) {
+      const vx::Tensor* mapped =
+          t->IsPlaceHolder()
+              ? nullptr
+              : graph_utils::MapTensor(t, dst_graph, tensor_map).get();
+      Append(key, mapped);
+    }
+    for (const auto& t : impl->OutputsTensor()) {
+      AppendSpec(key, t->GetSpec());
+    }
+
+    auto it = computed.find(key);
+    if (it == computed.end()) {
+      computed.emplace(std::move(key), op);
+      graph_utils::CloneOperation(op, dst_graph, tensor_map);
+      continue;
+    }
+    VSILOGD("Merge duplicated op %d", impl->kind_);
+    elimination.merged_ops++;
+    const auto& kept = it->second->impl()->OutputsTensor();
+    const auto& outputs = impl->OutputsTensor();
+    for (size_t i = 0; i < outputs.size(); ++i) {
+      tensor_map[outputs[i]] = tensor_map.at(kept[i]);
+      if (outputs[i]->GetSpec().attr_ == vx::TensorAttribute::TRANSIENT) {
+        elimination.saved_bytes += outputs[i]->GetSpec().GetByteSize();
+      }
+    }
+  }
+  if (report) {
+    *report = elimination;
+  }
+
+  return std::make_pair(dst_graph,
+                        graph_utils::GraphIoMap(src_graph, tensor_map));
+}
+
+}  // namespace transform
+}  // namespace tim
@@ -0,0 +1,165 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops.h"
+#include "tim/transform/common_subexpression_elimination.h"
+
+#include "gtest/gtest.h"
+
+TEST(CommonSubexpressionElimination, duplicated_heads) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType input_shape({2, 3});
+  tim::vx::ShapeType transposed_shape({3, 2});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, input_shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32,
+                                     transposed_shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, transposed_shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto input = src_graph->CreateTensor(input_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+  std::vector<std::shared_ptr<tim::vx::Tensor>> heads;
+  // Two heads repeating the same transpose and relu of the input
+  for (int i = 0; i < 2; ++i) {
+    auto transposed = src_graph->CreateTensor(transient_spec);
+    auto relu = src_graph->CreateTensor(transient_spec);
+    src_graph->CreateOperation<tim::vx::ops::Transpose>(
+                 std::vector<uint32_t>({1, 0}))
+        ->BindInput(input)
+        .BindOutput(transposed);
+    src_graph->CreateOperation<tim::vx::ops::Relu>()
+        ->BindInput(transposed)
+        .BindOutput(relu);
+    heads.push_back(relu);
+  }
+  src_graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs(heads)
+      .BindOutput(output);
+
+  tim::transform::CommonSubexpressionReport report;
+  auto transform =
+      tim::transform::EliminateCommonSubexpressions(src_graph, ctx, &report);
+  auto dst_graph = transform.first;
+  auto graph_io_map = transform.second;
+  EXPECT_EQ(report.merged_ops, 2);
+  EXPECT_EQ(report.saved_bytes, 2 * 6 * sizeof(float));
+
+  EXPECT_TRUE(dst_graph->Compile());
+  std::vector<float> in_data = {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f};
+  graph_io_map[input]->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float));
+  EXPECT_TRUE(dst_graph->Run());
+
+  std::vector<float> out_data(6);
+  EXPECT_TRUE(graph_io_map[output]->CopyDataFromTensor(out_data.data()));
+  std::vector<float> expect_output = {2.0f, 6.0f, 10.0f, 0.0f, 0.0f, 0.0f};
+  EXPECT_EQ(out_data, expect_output);
+}
+
+TEST(CommonSubexpressionElimination, keep_different_params) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType shape({2, 2});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto input = src_graph->CreateTensor(input_spec);
+  auto identity = src_graph->CreateTensor(transient_spec);
+  auto transposed = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+  // Same kind and output spec, only the permutation tells them apart
+  src_graph->CreateOperation<tim::vx::ops::Transpose>(
+               std::vector<uint32_t>({0, 1}))
+      ->BindInput(input)
+      .BindOutput(identity);
+  src_graph->CreateOperation<tim::vx::ops::Transpose>(
+               std::vector<uint32_t>({1, 0}))
+      ->BindInput(input)
+      .BindOutput(transposed);
+  src_graph->CreateOperation<tim::vx::ops::Sub>()
+      ->BindInputs({identity, transposed})
+      .BindOutput(output);
+
+  tim::transform::CommonSubexpressionReport report;
+  auto transform =
+      tim::transform::EliminateCommonSubexpressions(src_graph, ctx, &report);
+  auto dst_graph = transform.first;
+  auto graph_io_map = transform.second;
+  EXPECT_EQ(report.merged_ops, 0);
+
+  EXPECT_TRUE(dst_graph->Compile());
+  std::vector<float> in_data = {1.0f, 2.0f, 3.0f, 4.0f};
+  graph_io_map[input]->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float));
+  EXPECT_TRUE(dst_graph->Run());
+
+  std::vector<float> out_data(4);
+  EXPECT_TRUE(graph_io_map[output]->CopyDataFromTensor(out_data.data()));
+  std::vector<float> expect_output = {0.0f, -1.0f, 1.0f, 0.0f};
+  EXPECT_EQ(out_data, expect_output);
+}
+
+TEST(CommonSubexpressionElimination, merge_ops_with_local_state) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32,
+                                 tim::vx::ShapeType({2, 3}),
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec reshaped_spec(tim::vx::DataType::FLOAT32,
+                                    tim::vx::ShapeType({3, 2}),
+                                    tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec half_spec(tim::vx::DataType::FLOAT16,
+                                tim::vx::ShapeType({3, 2}),
+                                tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32,
+                                  tim::vx::ShapeType({3, 2}),
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto input = src_graph->CreateTensor(input_spec);
+  auto sum = src_graph->CreateTensor(half_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+  std::vector<std::shared_ptr<tim::vx::Tensor>> heads;
+  // Reshape and DataConvert allocate local data for every node
+  for (int i = 0; i < 2; ++i) {
+    auto reshaped = src_graph->CreateTensor(reshaped_spec);
+    auto half = src_graph->CreateTensor(half_spec);
+    src_graph->CreateOperation<tim::vx::ops::Reshape>(
+                 std::vector<uint32_t>({3, 2}))
+        ->BindInput(input)
+        .BindOutput(reshaped);
+    src_graph->CreateOperation<tim::vx::ops::DataConvert>()
+        ->BindInput(reshaped)
+        .BindOutput(half);
+    heads.push_back(half);
+  }
+  src_graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs(heads)
+      .BindOutput(sum);
+  src_graph->CreateOperation<tim::vx::ops::DataConvert>()
+      ->BindInput(sum)
+      .BindOutput(output);
+
+  tim::transform::CommonSubexpressionReport report;
+  auto transform =
+      tim::transform::EliminateCommonSubexpressions(src_graph, ctx, &report);
+  auto dst_graph = transform.first;
+  auto graph_io_map = transform.second;
+  EXPECT_EQ(report.merged_ops, 2);
+
+  EXPECT_TRUE(dst_graph->Compile());
+  std::vector<float> in_data = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  graph_io_map[input]->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float));
+  EXPECT_TRUE(dst_graph->Run());
+
+  std::vector<float> out_data(6);
+  EXPECT_TRUE(graph_io_map[output]->CopyDataFromTensor(out_data.data()));
+  std::vector<float> expect_output = {2.0f, 4.0f, 6.0f, 8.0f, 10.0f, 12.0f};
+  EXPECT_EQ(out_data, expect_output);
+}
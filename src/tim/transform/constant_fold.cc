@@ -0,0 +1,177 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/transform/constant_fold.h"
+
+#include <unordered_set>
+#include <vector>
+
+#include "graph_utils.h"
+#include "builtin_op_impl.h"
+#include "graph_private.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+bool IsFoldable(const std::shared_ptr<vx::Operation>& op,
+                const std::unordered_set<const vx::Tensor*>& const_tensors) {
+  // Compiled binaries and composite ops are never folded
+  if (!op->impl()->node() || op->impl()->kind_ == VSI_NN_OP_NBG) {
+    return false;
+  }
+  bool has_const = false;
+  for (const auto& t : op->impl()->InputsTensor()) {
+    if (t->IsPlaceHolder()) {
+      continue;
+    }
+    if (!t->IsConstTensor() && !const_tensors.count(t.get())) {
+      return false;
+    }
+    has_const = true;
+  }
+  for (const auto& t : op->impl()->OutputsTensor()) {
+    if (t->GetSpec().attr_ & vx::TensorAttribute::OUTPUT) {
+      return false;
+    }
+  }
+  return has_const;
+}
+
+uint64_t TensorBytes(const std::vector<std::shared_ptr<vx::Tensor>>& tensors) {
+  uint64_t bytes = 0;
+  for (const auto& t : tensors) {
+    if (!t->IsPlaceHolder()) {
+      bytes += t->GetSpec().GetByteSize();
+    }
+  }
+  return bytes;
+}
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+ConstantFold(const std::shared_ptr<vx::Graph>& src_graph,
+             std::shared_ptr<vx::Context>& ctx, ConstantFoldReport* report) {
+  auto ops = graph_utils::SortOperations(src_graph);
+
+  // Outputs of folded ops, they are constant too
+  std::unordered_set<const vx::Tensor*> const_tensors;
+  std::unordered_set<const vx::Operation*> folded;
+  for (const auto& op : ops) {
+    if (IsFoldable(op, const_tensors)) {
+      folded.insert(op.get());
+      for (const auto& t : op->impl()->OutputsTensor()) {
+        const_tensors.insert(t.get());
+      }
+    }
+  }
+
+  // Folded results still read by the rest of the graph
+  std::vector<std::shared_ptr<vx::Tensor>> frontier;
+  std::unordered_set<const vx::Tensor*> in_frontier;
+  for (const auto& op : ops) {
+    if (folded.count(op.get())) {
+      continue;
+    }
+    for (const auto& t : op->impl()->InputsTensor()) {
+      if (const_tensors.count(t.get()) && in_frontier.insert(t.get()).second) {
+        frontier.push_back(t);
+      }
+    }
+  }
+
+  std::vector<vx::TensorSpec> frontier_specs(frontier.size());
+  std::vector<std::vector<uint8_t>> frontier_data(frontier.size());
+  if (!frontier.empty()) {
+    auto eval_graph = ctx->CreateGraph();
+    graph_utils::TensorMap eval_map;
+    for (const auto& op : ops) {
+      if (!folded.count(op.get())) {
+        continue;
+      }
+      for (const auto& t : op->impl()->OutputsTensor()) {
+        auto spec = t->GetSpec();
+        spec.SetAttribute(in_frontier.count(t.get())
+                              ? vx::TensorAttribute::OUTPUT
+                              : vx::TensorAttribute::TRANSIENT);
+        eval_map[t] = eval_graph->CreateTensor(spec);
+      }
+      graph_utils::CloneOperation(op, eval_graph, eval_map);
+    }
+
+    bool status = eval_graph->Compile() && eval_graph->Run();
+    for (size_t i = 0; status && i < frontier.size(); ++i) {
+      // Take the shape ovxlib inferred, transient specs may leave it empty
+      auto eval_tensor = eval_map[frontier[i]];
+      vsi_nn_tensor_t* t = vsi_nn_GetTensor(
+          std::static_pointer_cast<vx::GraphImpl>(eval_graph)->graph(),
+          eval_tensor->GetId());
+      vx::ShapeType shape(t->attr.size, t->attr.size + t->attr.dim_num);
+      frontier_specs[i] = frontier[i]->GetSpec();
+      frontier_specs[i].SetShape(shape);
+      frontier_data[i].resize(frontier_specs[i].GetByteSize());
+      status = eval_tensor->CopyDataFromTensor(frontier_data[i].data());
+    }
+    if (!status) {
+      VSILOGW("Constant folding failed to evaluate, graph is left unfolded");
+      folded.clear();
+      frontier.clear();
+    }
+  }
+
+  std::shared_ptr<vx::Graph> fold_graph = ctx->CreateGraph();
+  graph_utils::TensorMap tensor_map;
+  for (size_t i = 0; i < frontier.size(); ++i) {
+    auto spec = frontier_specs[i];
+    spec.SetAttribute(vx::TensorAttribute::CONSTANT);
+    tensor_map[frontier[i]] =
+        std::static_pointer_cast<vx::GraphImpl>(fold_graph)
+            ->CreateOwnedTensor(spec, std::move(frontier_data[i]));
+  }
+
+  ConstantFoldReport fold_report;
+  for (const auto& op : ops) {
+    if (folded.count(op.get())) {
+      fold_report.folded_ops++;
+      fold_report.eliminated_bytes +=
+          TensorBytes(op->impl()->InputsTensor()) +
+          TensorBytes(op->impl()->OutputsTensor());
+    } else {
+      graph_utils::CloneOperation(op, fold_graph, tensor_map);
+    }
+  }
+  fold_report.folded_tensors = frontier.size();
+  if (report) {
+    *report = fold_report;
+  }
+
+  return std::make_pair(fold_graph,
+                        graph_utils::GraphIoMap(src_graph, tensor_map));
+}
+
+}  // namespace transform
+}  // namespace tim
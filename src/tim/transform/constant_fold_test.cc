@@ -0,0 +1,84 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops.h"
+#include "tim/transform/constant_fold.h"
+
+#include "gtest/gtest.h"
+
+TEST(ConstantFold, const_chain) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  std::vector<float> a_data = {1.0f, -2.0f, 3.0f, -4.0f};
+  std::vector<float> b_data = {0.5f, 0.5f, 0.5f, 0.5f};
+  auto input = src_graph->CreateTensor(input_spec);
+  auto a = src_graph->CreateTensor(const_spec, a_data.data());
+  auto b = src_graph->CreateTensor(const_spec, b_data.data());
+  auto sum = src_graph->CreateTensor(transient_spec);
+  auto relu_out = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  // relu(a + b) only depends on constants
+  src_graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({a, b}).BindOutput(sum);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(sum).BindOutput(relu_out);
+  src_graph->CreateOperation<tim::vx::ops::Multiply>()
+      ->BindInputs({input, relu_out}).BindOutput(output);
+
+  tim::transform::ConstantFoldReport report;
+  auto transform = tim::transform::ConstantFold(src_graph, ctx, &report);
+  auto fold_graph = transform.first;
+  auto graph_io_map = transform.second;
+  EXPECT_EQ(report.folded_ops, 2);
+  EXPECT_EQ(report.folded_tensors, 1);
+  EXPECT_EQ(report.eliminated_bytes, 5 * 4 * sizeof(float));
+
+  EXPECT_TRUE(fold_graph->Compile());
+  std::vector<float> in_data = {2.0f, 2.0f, 2.0f, 2.0f};
+  auto fold_input = graph_io_map[input];
+  auto fold_output = graph_io_map[output];
+  fold_input->CopyDataToTensor(in_data.data(), in_data.size() * sizeof(float));
+  EXPECT_TRUE(fold_graph->Run());
+
+  std::vector<float> out_data(4);
+  EXPECT_TRUE(fold_output->CopyDataFromTensor(out_data.data()));
+  std::vector<float> expect_output = {3.0f, 0.0f, 7.0f, 0.0f};
+  EXPECT_EQ(out_data, expect_output);
+}
+
+TEST(ConstantFold, keep_graph_output) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType shape({2});
+  tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  std::vector<float> a_data = {-1.0f, 1.0f};
+  auto a = src_graph->CreateTensor(const_spec, a_data.data());
+  auto output = src_graph->CreateTensor(output_spec);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(a).BindOutput(output);
+
+  tim::transform::ConstantFoldReport report;
+  auto transform = tim::transform::ConstantFold(src_graph, ctx, &report);
+  EXPECT_EQ(report.folded_ops, 0);
+  EXPECT_EQ(report.folded_tensors, 0);
+
+  auto fold_graph = transform.first;
+  auto fold_output = transform.second[output];
+  EXPECT_TRUE(fold_graph->Compile());
+  EXPECT_TRUE(fold_graph->Run());
+  std::vector<float> out_data(2);
+  EXPECT_TRUE(fold_output->CopyDataFromTensor(out_data.data()));
+  EXPECT_EQ(out_data, std::vector<float>({0.0f, 1.0f}));
+}
@@ -0,0 +1,106 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/transform/dead_op_elimination.h"
+
+#include <unordered_set>
+
+#include "graph_utils.h"
+#include "builtin_op_impl.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+
+namespace tim {
+namespace transform {
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+EliminateDeadOps(const std::shared_ptr<vx::Graph>& src_graph,
+                 std::shared_ptr<vx::Context>& ctx,
+                 DeadOpEliminationReport* report) {
+  auto ops = graph_utils::SortOperations(src_graph);
+
+  std::unordered_set<const vx::Tensor*> live;
+  for (const auto& t : src_graph->OutputsTensor()) {
+    live.insert(t.get());
+  }
+  std::unordered_set<const vx::Operation*> live_ops;
+  for (auto it = ops.rbegin(); it != ops.rend(); ++it) {
+    const auto& op = *it;
+    const auto& outputs = op->impl()->OutputsTensor();
+    bool is_live = false;
+    for (const auto& t : outputs) {
+      if (live.count(t.get()) ||
+          (t->GetSpec().attr_ & vx::TensorAttribute::OUTPUT)) {
+        is_live = true;
+        break;
+      }
+    }
+    if (!is_live) {
+      continue;
+    }
+    live_ops.insert(op.get());
+    for (const auto& t : op->impl()->InputsTensor()) {
+      live.insert(t.get());
+    }
+    for (const auto& t : outputs) {
+      live.insert(t.get());
+    }
+  }
+
+  std::shared_ptr<vx::Graph> dst_graph = ctx->CreateGraph();
+  graph_utils::TensorMap tensor_map;
+  DeadOpEliminationReport elimination;
+  std::unordered_set<const vx::Tensor*> removed;
+  for (const auto& op : ops) {
+    if (live_ops.count(op.get())) {
+      graph_utils::CloneOperation(op, dst_graph, tensor_map);
+      continue;
+    }
+    VSILOGD("Remove dead op %d", op->impl()->kind_);
+    elimination.removed_ops++;
+    for (const auto& tensors :
+         {op->impl()->InputsTensor(), op->impl()->OutputsTensor()}) {
+      for (const auto& t : tensors) {
+        if (t->IsPlaceHolder() || live.count(t.get()) ||
+            !removed.insert(t.get()).second) {
+          continue;
+        }
+        elimination.removed_tensors++;
+        if (t->GetSpec().attr_ == vx::TensorAttribute::TRANSIENT) {
+          elimination.saved_bytes += t->GetSpec().GetByteSize();
+        }
+      }
+    }
+  }
+  if (report) {
+    *report = elimination;
+  }
+
+  return std::make_pair(dst_graph,
+                        graph_utils::GraphIoMap(src_graph, tensor_map));
+}
+
+}  // namespace transform
+}  // namespace tim
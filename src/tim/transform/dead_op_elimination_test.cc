@@ -0,0 +1,82 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops.h"
+#include "tim/transform/dead_op_elimination.h"
+
+#include "gtest/gtest.h"
+
+TEST(DeadOpElimination, debug_branch) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto input = src_graph->CreateTensor(input_spec);
+  auto sum = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+  auto debug0 = src_graph->CreateTensor(transient_spec);
+  auto debug1 = src_graph->CreateTensor(transient_spec);
+
+  src_graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({input, input}).BindOutput(sum);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(sum).BindOutput(output);
+  // Branch left over by a converter, nothing reads it
+  src_graph->CreateOperation<tim::vx::ops::Sigmoid>()->BindInput(sum).BindOutput(debug0);
+  src_graph->CreateOperation<tim::vx::ops::Tanh>()->BindInput(debug0).BindOutput(debug1);
+
+  tim::transform::DeadOpEliminationReport report;
+  auto transform = tim::transform::EliminateDeadOps(src_graph, ctx, &report);
+  auto dst_graph = transform.first;
+  auto graph_io_map = transform.second;
+  EXPECT_EQ(report.removed_ops, 2);
+  EXPECT_EQ(report.removed_tensors, 2);
+  EXPECT_EQ(report.saved_bytes, 2 * 4 * sizeof(float));
+
+  EXPECT_TRUE(dst_graph->Compile());
+  std::vector<float> in_data = {1.0f, -2.0f, 3.0f, -4.0f};
+  graph_io_map[input]->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float));
+  EXPECT_TRUE(dst_graph->Run());
+
+  std::vector<float> out_data(4);
+  EXPECT_TRUE(graph_io_map[output]->CopyDataFromTensor(out_data.data()));
+  std::vector<float> expect_output = {2.0f, 0.0f, 6.0f, 0.0f};
+  EXPECT_EQ(out_data, expect_output);
+}
+
+TEST(DeadOpElimination, keep_variable_reader) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec variable_spec(tim::vx::DataType::FLOAT32, shape,
+                                    tim::vx::TensorAttribute::VARIABLE);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto input = src_graph->CreateTensor(input_spec);
+  auto state = src_graph->CreateTensor(variable_spec);
+  auto relu = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  // The relu only reads the variable, no graph input or constant leads to it
+  src_graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(state).BindOutput(relu);
+  src_graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({input, relu}).BindOutput(output);
+
+  tim::transform::DeadOpEliminationReport report;
+  auto transform = tim::transform::EliminateDeadOps(src_graph, ctx, &report);
+  auto dst_graph = transform.first;
+  auto graph_io_map = transform.second;
+  EXPECT_EQ(report.removed_ops, 0);
+  EXPECT_EQ(dst_graph->OpVector().size(), 2);
+  EXPECT_TRUE(dst_graph->GetProducerOp(graph_io_map[output]));
+}
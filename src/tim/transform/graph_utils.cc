@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "graph_utils.h"
+
+#include <algorithm>
+#include <deque>
+#include <unordered_set>
+
+#include "builtin_op_impl.h"
+
+namespace tim {
+namespace transform {
+namespace graph_utils {
+
+std::vector<std::shared_ptr<vx::Operation>> SortOperations(
+    const std::shared_ptr<vx::Graph>& graph) {
+  std::vector<std::shared_ptr<vx::Operation>> sorted;
+  std::unordered_set<const vx::Operation*> visited;
+  std::unordered_set<const vx::Tensor*> ready;
+  std::deque<std::shared_ptr<vx::Tensor>> tensor_queue;
+
+  auto is_ready = [&](const std::shared_ptr<vx::Tensor>& t) {
+    return ready.count(t.get()) || t->IsPlaceHolder() || t->IsConstTensor() ||
+           !graph->GetProducerOp(t);
+  };
+  auto visit = [&](const std::shared_ptr<vx::Operation>& op) {
+    if (visited.count(op.get()) || !op->impl()->node()) {
+      return;
+    }
+    const auto& inputs = op->impl()->InputsTensor();
+    if (!std::all_of(inputs.begin(), inputs.end(), is_ready)) {
+      return;
+    }
+    visited.insert(op.get());
+    sorted.push_back(op);
+    for (const auto& t : op->impl()->OutputsTensor()) {
+      ready.insert(t.get());
+      tensor_queue.push_back(t);
+    }
+  };
+
+  // Start from every op that can run first, not only the readers of graph
+  // inputs and constants: ops without inputs or reading variables only are
+  // reached by nothing else.
+  for (const auto& op : graph->OpVector()) {
+    visit(op);
+  }
+  while (!tensor_queue.empty()) {
+    auto tensor = tensor_queue.front();
+    tensor_queue.pop_front();
+    for (const auto& op : graph->GetConsumersOp(tensor)) {
+      visit(op);
+    }
+  }
+  return sorted;
+}
+
+std::shared_ptr<vx::Tensor> MapTensor(const std::shared_ptr<vx::Tensor>& src,
+                                      const std::shared_ptr<vx::Graph>& dst,
+                                      TensorMap& tensor_map) {
+  auto it = tensor_map.find(src);
+  if (it != tensor_map.end()) {
+    return it->second;
+  }
+  std::shared_ptr<vx::Tensor> mapped;
+  if (src->IsPlaceHolder()) {
+    mapped = dst->CreateTensorPlaceHolder();
+  } else if (src->IsConstTensor()) {
+    mapped = dst->CreateTensor(src->GetSpec(), src->GetDataRef());
+  } else {
+    mapped = dst->CreateTensor(src->GetSpec());
+  }
+  tensor_map[src] = mapped;
+  return mapped;
+}
+
+std::shared_ptr<vx::Operation> CloneOperation(
+    const std::shared_ptr<vx::Operation>& op, std::shared_ptr<vx::Graph>& dst,
+    TensorMap& tensor_map) {
+  auto cloned_op = op->Clone(dst);
+  // Clone() rebuilds the op from its parameters, carry over the node state
+  // set after construction, like the activation FuseActivations merged
+  if (op->impl()->node() && cloned_op->impl()->node()) {
+    cloned_op->impl()->kind_ = op->impl()->kind_;
+    cloned_op->impl()->node()->op = op->impl()->node()->op;
+    cloned_op->impl()->node()->vx_param = op->impl()->node()->vx_param;
+  }
+  for (const auto& t : op->impl()->InputsTensor()) {
+    cloned_op->BindInput(MapTensor(t, dst, tensor_map));
+  }
+  for (const auto& t : op->impl()->OutputsTensor()) {
+    cloned_op->BindOutput(MapTensor(t, dst, tensor_map));
+  }
+  return cloned_op;
+}
+
+TensorMap GraphIoMap(const std::shared_ptr<vx::Graph>& src,
+                     const TensorMap& tensor_map) {
+  TensorMap io_map;
+  for (const auto& t : src->InputsTensor()) {
+    auto it = tensor_map.find(t);
+    if (it != tensor_map.end()) {
+      io_map.insert(*it);
+    }
+  }
+  for (const auto& t : src->OutputsTensor()) {
+    auto it = tensor_map.find(t);
+    if (it != tensor_map.end()) {
+      io_map.insert(*it);
+    }
+  }
+  return io_map;
+}
+
+}  // namespace graph_utils
+}  // namespace transform
+}  // namespace tim
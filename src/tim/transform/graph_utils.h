@@ -0,0 +1,67 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_TRANSFORM_GRAPH_UTILS_H_
+#define TIM_TRANSFORM_GRAPH_UTILS_H_
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "tim/vx/tensor.h"
+
+namespace tim {
+namespace transform {
+namespace graph_utils {
+
+using TensorMap =
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>;
+
+/// Operations of the graph, every op comes after the producers of its
+/// inputs. Composite ops, which own no node, are
+/// left out, the builtin ops they are made of are listed instead.
+std::vector<std::shared_ptr<vx::Operation>> SortOperations(
+    const std::shared_ptr<vx::Graph>& graph);
+
+/// Tensor of `dst` standing for `src`, created with the spec, and the data
+/// for constants, of `src` the first time it is asked for.
+std::shared_ptr<vx::Tensor> MapTensor(const std::shared_ptr<vx::Tensor>& src,
+                                      const std::shared_ptr<vx::Graph>& dst,
+                                      TensorMap& tensor_map);
+
+/// Clone `op` into `dst` with its tensors mapped by MapTensor()
+std::shared_ptr<vx::Operation> CloneOperation(
+    const std::shared_ptr<vx::Operation>& op, std::shared_ptr<vx::Graph>& dst,
+    TensorMap& tensor_map);
+
+/// Graph inputs and outputs of `src` mapped to their tensors in the new graph
+TensorMap GraphIoMap(const std::shared_ptr<vx::Graph>& src,
+                     const TensorMap& tensor_map);
+
+}  // namespace graph_utils
+}  // namespace transform
+}  // namespace tim
+
+#endif
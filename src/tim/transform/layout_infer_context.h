@@ -1,5 +1,7 @@
 #ifndef TIM_VX_LAYOUT_INFER_CONTEXT_H_
 #define TIM_VX_LAYOUT_INFER_CONTEXT_H_
+#include <unordered_set>
+
 #include "permute_vector.h"
 #include "tim/transform/layout_inference.h"
 
@@ -18,6 +20,20 @@ class LayoutInferContext {
   void MarkVisited(const std::shared_ptr<vx::Operation>& op);
   bool IsVisited(const std::shared_ptr<vx::Operation>& op) const;
   bool IsReadyForInfer(const std::shared_ptr<vx::Operation>& op) const;
+  // Pick the layout an op aligns its inputs to, out of the ones its inputs
+  // already have. Greedy inference takes the first one, the global mode
+  // steers the choice per op through SetPermuteChoices.
+  std::shared_ptr<IPermuteVector> ChoosePermuteVector(
+      const std::shared_ptr<vx::Operation>& op,
+      const std::vector<std::shared_ptr<IPermuteVector>>& candidates);
+  void SetPermuteChoices(const std::map<const vx::Operation*, uint32_t>& choices) {
+    permute_choices_ = choices;
+  }
+  // Ops which had more than one layout to choose from, with the count
+  const std::vector<std::pair<const vx::Operation*, uint32_t>>&
+  GetPermuteDecisions() const {
+    return permute_decisions_;
+  }
   void UpdateTensorMap(const std::shared_ptr<vx::Tensor>& t_src,
                        const std::shared_ptr<vx::Tensor>& t_layout);
   std::shared_ptr<vx::Tensor> GetMapedTensor(
@@ -44,7 +60,7 @@ class LayoutInferContext {
  private:
   std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<IPermuteVector>>
       tensor_pv_;
-  std::vector<std::shared_ptr<vx::Operation>> visited_op_;
+  std::unordered_set<std::shared_ptr<vx::Operation>> visited_op_;
   // tensor_in_src -> tensor_in_layout
   std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>
       tensor_map_;
@@ -52,6 +68,8 @@ class LayoutInferContext {
       graph_input_map_;
   std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>
       graph_output_map_;
+  std::map<const vx::Operation*, uint32_t> permute_choices_;
+  std::vector<std::pair<const vx::Operation*, uint32_t>> permute_decisions_;
 };
 
 }  // namespace layout_inference_impl
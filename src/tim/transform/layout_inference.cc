@@ -24,6 +24,8 @@
 
 #include "permute_vector.h"
 #include "layout_infer_context.h"
+#include "graph_utils.h"
+#include "builtin_op_impl.h"
 
 #include "tim/transform/layout_inference.h"
 #include "ops/conv2d_layout_inference.h"
@@ -77,6 +79,12 @@
 
 namespace tim {
 namespace transform {
+namespace {
+// Bound on the rounds of the global layout search, each round tries every
+// alternative once
+constexpr uint32_t kMaxLayoutSearchPasses = 4;
+}  // namespace
+
 namespace layout_inference_impl {
 
 std::vector<std::shared_ptr<vx::Tensor>> HandleLayoutInfer(
@@ -106,21 +114,13 @@ const std::shared_ptr<IPermuteVector> LayoutInferContext::GetPermuteVector(
 }
 
 void LayoutInferContext::MarkVisited(const std::shared_ptr<vx::Operation>& op) {
-  if (visited_op_.end() !=
-      std::find(visited_op_.begin(), visited_op_.end(), op)) {
+  if (!visited_op_.insert(op).second) {
     VSILOGW("The operation has been mark as visited.");
-  } else {
-    visited_op_.push_back(op);
   }
 }
 
 bool LayoutInferContext::IsVisited(const std::shared_ptr<vx::Operation>& op) const {
-  if (visited_op_.end() !=
-      std::find(visited_op_.begin(), visited_op_.end(), op)) {
-    return true;
-  } else {
-    return false;
-  }
+  return visited_op_.count(op) != 0;
 }
 
 bool LayoutInferContext::IsReadyForInfer(
@@ -134,6 +134,36 @@ bool LayoutInferContext::IsReadyForInfer(
   return true;
 }
 
+std::shared_ptr<IPermuteVector> LayoutInferContext::ChoosePermuteVector(
+    const std::shared_ptr<vx::Operation>& op,
+    const std::vector<std::shared_ptr<IPermuteVector>>& candidates) {
+  if (candidates.empty()) {
+    return nullptr;
+  }
+  std::vector<std::shared_ptr<IPermuteVector>> distinct;
+  for (const auto& pv : candidates) {
+    // Inputs of other ranks are broadcasted, they can't lead the layout
+    if (pv->Rank() != candidates[0]->Rank()) {
+      continue;
+    }
+    auto same = [&pv](const std::shared_ptr<IPermuteVector>& other) {
+      return other->AsStdVec() == pv->AsStdVec();
+    };
+    if (std::none_of(distinct.begin(), distinct.end(), same)) {
+      distinct.push_back(pv);
+    }
+  }
+  if (distinct.size() == 1) {
+    return distinct[0];
+  }
+  permute_decisions_.emplace_back(op.get(), distinct.size());
+  auto choice = permute_choices_.find(op.get());
+  if (choice == permute_choices_.end()) {
+    return distinct[0];
+  }
+  return distinct[choice->second % distinct.size()];
+}
+
 void LayoutInferContext::UpdateTensorMap(
     const std::shared_ptr<vx::Tensor>& t_src,
     const std::shared_ptr<vx::Tensor>& t_layout) {
@@ -288,19 +318,37 @@ std::vector<std::shared_ptr<vx::Tensor>> HandleLayoutInfer(
 }
 }  // namespace layout_inference_impl
 
-std::pair<std::shared_ptr<vx::Graph>,
-          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
-LayoutInference(
+namespace {
+struct InferResult {
+  std::shared_ptr<vx::Graph> graph;
+  std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>> io_map;
+  std::vector<std::pair<const vx::Operation*, uint32_t>> decisions;
+  PermuteOptimizationReport report;
+};
+
+uint64_t TransposeBytes(const std::shared_ptr<vx::Graph>& graph) {
+  uint64_t bytes = 0;
+  for (const auto& op : graph_utils::SortOperations(graph)) {
+    if (op->impl()->kind_ == VSI_NN_OP_PERMUTE) {
+      bytes += op->impl()->InputsTensor()[0]->GetSpec().GetByteSize();
+    }
+  }
+  return bytes;
+}
+
+InferResult InferLayout(
     const std::shared_ptr<vx::Graph>& src_graph,
     std::shared_ptr<vx::Context>& ctx,
-    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<IPermuteVector>>
-        tensor_pv_map) {
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<IPermuteVector>>&
+        tensor_pv_map,
+    const std::map<const vx::Operation*, uint32_t>& permute_choices) {
   std::shared_ptr<vx::Graph> infer_graph = ctx->CreateGraph();
   std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>
       graph_io_map;
   auto layout_infer_ctx =
       std::make_shared<layout_inference_impl::LayoutInferContext>(src_graph,
                                                                   infer_graph);
+  layout_infer_ctx->SetPermuteChoices(permute_choices);
 
   std::deque<std::shared_ptr<vx::Tensor>> tensor_queue;
   auto graph_inputs = src_graph->InputsTensor();
@@ -348,7 +396,69 @@ LayoutInference(
   for (const auto& graph_output : layout_infer_ctx->GetGraphOutputMap()) {
     graph_io_map[graph_output.first] = graph_output.second;
   }
-  return std::make_pair(infer_graph, graph_io_map);
+
+  InferResult result;
+  auto optimized = OptimizePermutes(infer_graph, ctx, &result.report);
+  // io tensors missing from the optimized io map still need a tensor in the
+  // graph handed back, not one of the discarded infer_graph
+  graph_utils::TensorMap optimized_map = optimized.second;
+  for (auto& io : graph_io_map) {
+    io.second =
+        graph_utils::MapTensor(io.second, optimized.first, optimized_map);
+  }
+  result.graph = optimized.first;
+  result.io_map = graph_io_map;
+  result.decisions = layout_infer_ctx->GetPermuteDecisions();
+  result.report.transpose_bytes = TransposeBytes(result.graph);
+  return result;
+}
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+LayoutInference(
+    const std::shared_ptr<vx::Graph>& src_graph,
+    std::shared_ptr<vx::Context>& ctx,
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<IPermuteVector>>
+        tensor_pv_map,
+    PermuteOptimizationReport* report, LayoutInferenceMode mode) {
+  std::map<const vx::Operation*, uint32_t> choices;
+  auto best = InferLayout(src_graph, ctx, tensor_pv_map, choices);
+
+  if (mode == LayoutInferenceMode::GLOBAL_COST) {
+    // Coordinate descent over the ops which could align their inputs to more
+    // than one layout: try each alternative with the rest fixed and keep it
+    // if the graph ends up reading less data through Transposes.
+    bool improved = true;
+    for (uint32_t pass = 0; improved && pass < kMaxLayoutSearchPasses;
+         pass++) {
+      improved = false;
+      auto decisions = best.decisions;
+      for (const auto& decision : decisions) {
+        uint32_t current =
+            choices.count(decision.first) ? choices[decision.first] : 0;
+        for (uint32_t alt = 0; alt < decision.second; alt++) {
+          if (alt == current) {
+            continue;
+          }
+          auto trial_choices = choices;
+          trial_choices[decision.first] = alt;
+          auto trial = InferLayout(src_graph, ctx, tensor_pv_map, trial_choices);
+          if (trial.report.transpose_bytes < best.report.transpose_bytes) {
+            best = trial;
+            choices = trial_choices;
+            current = alt;
+            improved = true;
+          }
+        }
+      }
+    }
+  }
+
+  if (report) {
+    *report = best.report;
+  }
+  return std::make_pair(best.graph, best.io_map);
 }
 
 }  // namespace transform
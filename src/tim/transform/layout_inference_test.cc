@@ -1,6 +1,11 @@
+#include <algorithm>
+
 #include "tim/vx/context.h"
 #include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/concat.h"
 #include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/elementwise.h"
 #include "tim/transform/layout_inference.h"
 
 #include "gtest/gtest.h"
@@ -116,4 +121,138 @@ TEST(LayoutInference, weight_as_input_conv2d) {
                           sizeof(float) * out_data.size()));
   tim::vx::ShapeType expect_shape({2, 2, 1, 1});
   EXPECT_EQ(infer_out_shape, expect_shape);
-}
\ No newline at end of file
+}
+namespace {
+// 1x1 NHWC convolution with the weights in IcWHOc layout
+void AddPointwiseConv2d(const std::shared_ptr<tim::vx::Graph>& graph,
+                        const std::shared_ptr<tim::vx::Tensor>& input,
+                        const std::shared_ptr<tim::vx::Tensor>& output,
+                        const std::vector<float>& weight_data) {
+  uint32_t in_channels = input->GetShape()[0];
+  uint32_t out_channels = output->GetShape()[0];
+  tim::vx::ShapeType weight_shape({in_channels, 1, 1, out_channels});
+  tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32, weight_shape,
+                                  tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {out_channels},
+                                tim::vx::TensorAttribute::CONSTANT);
+  std::vector<float> bias_data(out_channels, 0.0f);
+  auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+  auto bias = graph->CreateTensor(bias_spec, bias_data.data());
+  auto conv2d = graph->CreateOperation<tim::vx::ops::Conv2d>(
+      out_channels, tim::vx::PadType::VALID, std::array<uint32_t, 2>({1, 1}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}), 0,
+      tim::vx::DataLayout::CWHN, tim::vx::DataLayout::IcWHOc);
+  (*conv2d).BindInputs({input, weight, bias}).BindOutput(output);
+}
+
+std::vector<float> RunInferGraph(
+    const std::shared_ptr<tim::vx::Graph>& src_graph,
+    std::pair<std::shared_ptr<tim::vx::Graph>,
+              std::map<std::shared_ptr<tim::vx::Tensor>,
+                       std::shared_ptr<tim::vx::Tensor>>>& transform,
+    const std::vector<std::vector<float>>& inputs_data) {
+  auto infer_graph = transform.first;
+  EXPECT_TRUE(infer_graph->Compile());
+  for (size_t i = 0; i < inputs_data.size(); i++) {
+    transform.second[src_graph->InputsTensor()[i]]->CopyDataToTensor(
+        inputs_data[i].data(), inputs_data[i].size() * sizeof(float));
+  }
+  EXPECT_TRUE(infer_graph->Run());
+  auto infer_output = transform.second[src_graph->OutputsTensor()[0]];
+  std::vector<float> out_data(infer_output->GetSpec().GetElementNum());
+  EXPECT_TRUE(infer_output->CopyDataFromTensor(out_data.data()));
+  return out_data;
+}
+}  // namespace
+
+TEST(LayoutInference, global_cost_residual) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  tim::vx::ShapeType shape({2, 3, 3, 1});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto x = src_graph->CreateTensor(input_spec);
+  auto y = src_graph->CreateTensor(input_spec);
+  auto conv_out = src_graph->CreateTensor(transient_spec);
+  auto sum = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  // conv(y + conv(x)), the greedy pass aligns the add to y and has to
+  // transpose both the first conv output and the sum
+  std::vector<float> identity = {1.0f, 0.0f, 0.0f, 1.0f};
+  AddPointwiseConv2d(src_graph, x, conv_out, identity);
+  src_graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs({y, conv_out}).BindOutput(sum);
+  AddPointwiseConv2d(src_graph, sum, output, identity);
+
+  tim::transform::PermuteOptimizationReport greedy_report, global_report;
+  auto greedy = tim::transform::LayoutInference(src_graph, ctx, {},
+                                                &greedy_report);
+  auto global = tim::transform::LayoutInference(
+      src_graph, ctx, {}, &global_report,
+      tim::transform::LayoutInferenceMode::GLOBAL_COST);
+  EXPECT_LT(global_report.transpose_bytes, greedy_report.transpose_bytes);
+
+  std::vector<float> x_data(18), y_data(18), expect_output(18);
+  for (size_t i = 0; i < x_data.size(); i++) {
+    x_data[i] = static_cast<float>(i);
+    y_data[i] = 0.5f * static_cast<float>(i % 4);
+    expect_output[i] = x_data[i] + y_data[i];
+  }
+  EXPECT_EQ(RunInferGraph(src_graph, greedy, {x_data, y_data}), expect_output);
+  EXPECT_EQ(RunInferGraph(src_graph, global, {x_data, y_data}), expect_output);
+}
+
+TEST(LayoutInference, global_cost_concat) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+  tim::vx::ShapeType shape({2, 3, 3, 1});
+  tim::vx::ShapeType concat_shape({4, 3, 3, 1});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec concat_spec(tim::vx::DataType::FLOAT32, concat_shape,
+                                  tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto x = src_graph->CreateTensor(input_spec);
+  auto y = src_graph->CreateTensor(input_spec);
+  auto conv_out = src_graph->CreateTensor(transient_spec);
+  auto relu_out = src_graph->CreateTensor(transient_spec);
+  auto concat_out = src_graph->CreateTensor(concat_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  // conv(concat(relu(y), conv(x))) along channels, the greedy pass follows
+  // the relu branch and transposes the conv branch and the concat back
+  std::vector<float> identity = {1.0f, 0.0f, 0.0f, 1.0f};
+  std::vector<float> pairwise_sum = {1.0f, 0.0f, 1.0f, 0.0f,
+                                     0.0f, 1.0f, 0.0f, 1.0f};
+  AddPointwiseConv2d(src_graph, x, conv_out, identity);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()
+      ->BindInput(y).BindOutput(relu_out);
+  src_graph->CreateOperation<tim::vx::ops::Concat>(0, 2)
+      ->BindInputs({relu_out, conv_out}).BindOutput(concat_out);
+  AddPointwiseConv2d(src_graph, concat_out, output, pairwise_sum);
+
+  tim::transform::PermuteOptimizationReport greedy_report, global_report;
+  auto greedy = tim::transform::LayoutInference(src_graph, ctx, {},
+                                                &greedy_report);
+  auto global = tim::transform::LayoutInference(
+      src_graph, ctx, {}, &global_report,
+      tim::transform::LayoutInferenceMode::GLOBAL_COST);
+  EXPECT_LT(global_report.transpose_bytes, greedy_report.transpose_bytes);
+
+  std::vector<float> x_data(18), y_data(18), expect_output(18);
+  for (size_t i = 0; i < x_data.size(); i++) {
+    x_data[i] = static_cast<float>(i);
+    y_data[i] = (i % 2) ? -1.0f : 2.0f;
+    expect_output[i] = x_data[i] + std::max(y_data[i], 0.0f);
+  }
+  EXPECT_EQ(RunInferGraph(src_graph, greedy, {x_data, y_data}), expect_output);
+  EXPECT_EQ(RunInferGraph(src_graph, global, {x_data, y_data}), expect_output);
+}
@@ -197,13 +197,14 @@ OpLayoutInfer::AlignPermuteVectorForMutilInputs() {
   auto src_inputs = op_->impl()->InputsTensor();
   // Suppose the inputs have same dimension rank
   // TODO(yzw): should choose a optimal required_pv
-  std::shared_ptr<IPermuteVector> required_pv = nullptr;
+  std::vector<std::shared_ptr<IPermuteVector>> candidates;
   for (const auto& in : src_inputs) {
     if (!in->IsConstTensor()) {
-      required_pv = context_->GetPermuteVector(in);
-      break;
+      candidates.push_back(context_->GetPermuteVector(in));
     }
   }
+  std::shared_ptr<IPermuteVector> required_pv =
+      context_->ChoosePermuteVector(op_, candidates);
 
   if (!required_pv) {
     // all inputs are constant tensors
@@ -238,15 +239,18 @@ OpLayoutInfer::AlignPermuteVectorForMutilInputs() {
 std::shared_ptr<IPermuteVector>
 OpLayoutInfer::AlignPermuteVectorForElementWise() {
   auto src_inputs = op_->impl()->InputsTensor();
-  std::shared_ptr<IPermuteVector> required_pv = nullptr;
+  std::vector<std::shared_ptr<IPermuteVector>> candidates;
   std::shared_ptr<vx::Tensor> ref_input;
   for (const auto& in : src_inputs) {
     if (!in->IsConstTensor()) {
-      required_pv = context_->GetPermuteVector(in);
-      ref_input = in;
-      break;
+      candidates.push_back(context_->GetPermuteVector(in));
+      if (!ref_input) {
+        ref_input = in;
+      }
     }
   }
+  std::shared_ptr<IPermuteVector> required_pv =
+      context_->ChoosePermuteVector(op_, candidates);
 
   for (auto i_src : src_inputs) {
     std::shared_ptr<vx::Tensor> perm_out;
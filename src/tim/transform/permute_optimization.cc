@@ -0,0 +1,164 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/transform/layout_inference.h"
+
+#include <unordered_map>
+
+#include "graph_utils.h"
+#include "permute_vector.h"
+#include "builtin_op_impl.h"
+#include "graph_private.h"
+#include "type_utils.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "tim/vx/ops/transpose.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+// A Transpose kept aside until its result is read by another kind of op
+struct PendingPermute {
+  std::shared_ptr<vx::Tensor> base;
+  IPermuteVectorPtr pv;
+};
+
+IPermuteVectorPtr GetPermuteVector(const std::shared_ptr<vx::Operation>& op) {
+  const auto& param = op->impl()->node()->nn_param.permute;
+  IPermuteVectorPtr pv = MakeShared(param.dim_num);
+  for (uint32_t i = 0; i < param.dim_num; i++) {
+    pv->At(i) = param.perm[i];
+  }
+  return pv;
+}
+
+bool TransposeData(const std::shared_ptr<vx::Tensor>& input,
+                   const IPermuteVectorPtr& pv, std::vector<uint8_t>& data) {
+  if (!input->GetDataRef()) {
+    return false;
+  }
+  auto shape = input->GetShape();
+  uint32_t rank = static_cast<uint32_t>(shape.size());
+  if (rank != pv->Rank()) {
+    return false;
+  }
+  // vsi_nn_Transpose takes the outermost dimension first
+  std::vector<vsi_size_t> native_shape(shape.rbegin(), shape.rend());
+  std::vector<vsi_size_t> native_perm(rank);
+  for (uint32_t i = 0; i < rank; i++) {
+    native_perm[i] = rank - 1 - pv->At(rank - 1 - i);
+  }
+  auto vx_type = vx::TranslateDataType(input->GetDataType());
+  data.resize(input->GetSpec().GetByteSize());
+  vsi_nn_Transpose(data.data(), (uint8_t*)(input->GetDataRef()),
+                   native_shape.data(), rank, native_perm.data(), vx_type);
+  return true;
+}
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+OptimizePermutes(const std::shared_ptr<vx::Graph>& src_graph,
+                 std::shared_ptr<vx::Context>& ctx,
+                 PermuteOptimizationReport* report) {
+  auto ops = graph_utils::SortOperations(src_graph);
+  std::shared_ptr<vx::Graph> dst_graph = ctx->CreateGraph();
+  graph_utils::TensorMap tensor_map;
+  std::unordered_map<const vx::Tensor*, PendingPermute> pending;
+  PermuteOptimizationReport optimization;
+  uint32_t src_permutes = 0;
+  uint32_t dst_permutes = 0;
+
+  auto emit_permute = [&](const PendingPermute& permute,
+                          const std::shared_ptr<vx::Tensor>& out) {
+    auto input = graph_utils::MapTensor(permute.base, dst_graph, tensor_map);
+    auto output = graph_utils::MapTensor(out, dst_graph, tensor_map);
+    dst_graph->CreateOperation<vx::ops::Transpose>(permute.pv->AsStdVec())
+        ->BindInput(input)
+        .BindOutput(output);
+    dst_permutes++;
+  };
+
+  // Give a pending Transpose result a tensor in the new graph
+  auto materialize = [&](const std::shared_ptr<vx::Tensor>& t) {
+    auto it = pending.find(t.get());
+    if (it == pending.end() || tensor_map.count(t)) {
+      return;
+    }
+    if (it->second.pv->IsAligned()) {
+      tensor_map[t] =
+          graph_utils::MapTensor(it->second.base, dst_graph, tensor_map);
+    } else {
+      emit_permute(it->second, t);
+    }
+  };
+
+  for (const auto& op : ops) {
+    if (op->impl()->kind_ != VSI_NN_OP_PERMUTE) {
+      for (const auto& t : op->impl()->InputsTensor()) {
+        materialize(t);
+      }
+      graph_utils::CloneOperation(op, dst_graph, tensor_map);
+      continue;
+    }
+
+    src_permutes++;
+    auto input = op->impl()->InputsTensor()[0];
+    auto output = op->impl()->OutputsTensor()[0];
+    PendingPermute permute{input, GetPermuteVector(op)};
+    auto it = pending.find(input.get());
+    if (it != pending.end()) {
+      permute.base = it->second.base;
+      permute.pv = it->second.pv->Add(permute.pv);
+    }
+
+    if (output->GetSpec().attr_ & vx::TensorAttribute::OUTPUT) {
+      // Graph outputs have to be written, even by an identity
+      emit_permute(permute, output);
+      continue;
+    }
+    std::vector<uint8_t> data;
+    if (permute.base->IsConstTensor() &&
+        TransposeData(permute.base, permute.pv, data)) {
+      auto spec = output->GetSpec();
+      spec.SetAttribute(vx::TensorAttribute::CONSTANT);
+      tensor_map[output] = std::static_pointer_cast<vx::GraphImpl>(dst_graph)
+                               ->CreateOwnedTensor(spec, std::move(data));
+      optimization.folded++;
+      continue;
+    }
+    pending[output.get()] = permute;
+  }
+
+  optimization.removed = src_permutes - optimization.folded - dst_permutes;
+  if (report) {
+    *report = optimization;
+  }
+  return std::make_pair(dst_graph,
+                        graph_utils::GraphIoMap(src_graph, tensor_map));
+}
+
+}  // namespace transform
+}  // namespace tim
@@ -0,0 +1,95 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops.h"
+#include "tim/transform/layout_inference.h"
+
+#include "gtest/gtest.h"
+
+TEST(OptimizePermutes, cancel_back_to_back) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType nchw_shape({2, 3, 1, 1});
+  tim::vx::ShapeType nhwc_shape({1, 2, 3, 1});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, nchw_shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec nhwc_spec(tim::vx::DataType::FLOAT32, nhwc_shape,
+                                tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec nchw_spec(tim::vx::DataType::FLOAT32, nchw_shape,
+                                tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, nchw_shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto input = src_graph->CreateTensor(input_spec);
+  auto to_nhwc = src_graph->CreateTensor(nhwc_spec);
+  auto to_nchw = src_graph->CreateTensor(nchw_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  src_graph->CreateOperation<tim::vx::ops::Transpose>(
+      std::vector<uint32_t>({2, 0, 1, 3}))->BindInput(input).BindOutput(to_nhwc);
+  src_graph->CreateOperation<tim::vx::ops::Transpose>(
+      std::vector<uint32_t>({1, 2, 0, 3}))->BindInput(to_nhwc).BindOutput(to_nchw);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(to_nchw).BindOutput(output);
+
+  tim::transform::PermuteOptimizationReport report;
+  auto transform = tim::transform::OptimizePermutes(src_graph, ctx, &report);
+  EXPECT_EQ(report.removed, 2);
+  EXPECT_EQ(report.folded, 0);
+
+  auto opt_graph = transform.first;
+  EXPECT_TRUE(opt_graph->Compile());
+  std::vector<float> in_data = {1.0f, -2.0f, 3.0f, -4.0f, 5.0f, -6.0f};
+  transform.second[input]->CopyDataToTensor(in_data.data(),
+                                            in_data.size() * sizeof(float));
+  EXPECT_TRUE(opt_graph->Run());
+
+  std::vector<float> out_data(in_data.size());
+  EXPECT_TRUE(transform.second[output]->CopyDataFromTensor(out_data.data()));
+  std::vector<float> expect_output = {1.0f, 0.0f, 3.0f, 0.0f, 5.0f, 0.0f};
+  EXPECT_EQ(out_data, expect_output);
+}
+
+TEST(OptimizePermutes, fold_constant) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType shape({3, 2});
+  tim::vx::ShapeType transposed_shape({2, 3});
+  tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, transposed_shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32,
+                                     transposed_shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, transposed_shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  std::vector<float> const_data = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  auto input = src_graph->CreateTensor(input_spec);
+  auto weight = src_graph->CreateTensor(const_spec, const_data.data());
+  auto transposed = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  src_graph->CreateOperation<tim::vx::ops::Transpose>(
+      std::vector<uint32_t>({1, 0}))->BindInput(weight).BindOutput(transposed);
+  src_graph->CreateOperation<tim::vx::ops::Add>()
+      ->BindInputs({input, transposed}).BindOutput(output);
+
+  tim::transform::PermuteOptimizationReport report;
+  auto transform = tim::transform::OptimizePermutes(src_graph, ctx, &report);
+  EXPECT_EQ(report.removed, 0);
+  EXPECT_EQ(report.folded, 1);
+
+  auto opt_graph = transform.first;
+  EXPECT_TRUE(opt_graph->Compile());
+  std::vector<float> in_data(6, 0.0f);
+  transform.second[input]->CopyDataToTensor(in_data.data(),
+                                            in_data.size() * sizeof(float));
+  EXPECT_TRUE(opt_graph->Run());
+
+  std::vector<float> out_data(in_data.size());
+  EXPECT_TRUE(transform.second[output]->CopyDataFromTensor(out_data.data()));
+  std::vector<float> expect_output = {1.0f, 4.0f, 2.0f, 5.0f, 3.0f, 6.0f};
+  EXPECT_EQ(out_data, expect_output);
+}
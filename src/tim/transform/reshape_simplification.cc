@@ -0,0 +1,134 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/transform/reshape_simplification.h"
+
+#include <unordered_map>
+
+#include "graph_utils.h"
+#include "builtin_op_impl.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "tim/vx/ops/reshape.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+
+bool SameElements(const vx::TensorSpec& a, const vx::TensorSpec& b) {
+  const vx::Quantization& qa = a.quantization_;
+  const vx::Quantization& qb = b.quantization_;
+  return a.datatype_ == b.datatype_ && qa.Type() == qb.Type() &&
+         qa.ChannelDim() == qb.ChannelDim() && qa.Scales() == qb.Scales() &&
+         qa.ZeroPoints() == qb.ZeroPoints() &&
+         !a.shape_.empty() && !b.shape_.empty() &&
+         a.GetElementNum() == b.GetElementNum();
+}
+
+/// Reshape and Squeeze only relabel the shape of their input
+bool IsCollapsible(const std::shared_ptr<vx::Operation>& op) {
+  auto kind = op->impl()->kind_;
+  if (kind != VSI_NN_OP_RESHAPE2 && kind != VSI_NN_OP_RESHAPE &&
+      kind != VSI_NN_OP_SQUEEZE) {
+    return false;
+  }
+  const auto& inputs = op->impl()->InputsTensor();
+  const auto& outputs = op->impl()->OutputsTensor();
+  return inputs.size() == 1 && outputs.size() == 1 &&
+         !inputs[0]->IsPlaceHolder() &&
+         SameElements(inputs[0]->GetSpec(), outputs[0]->GetSpec());
+}
+
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+SimplifyReshapes(const std::shared_ptr<vx::Graph>& src_graph,
+                 std::shared_ptr<vx::Context>& ctx,
+                 ReshapeSimplificationReport* report) {
+  auto ops = graph_utils::SortOperations(src_graph);
+
+  // The output of a collapsible op is written only if something other than
+  // a collapsible op reads it, the others start from the chain root
+  auto needs_output = [&src_graph](const std::shared_ptr<vx::Tensor>& t) {
+    if (t->GetSpec().attr_ & vx::TensorAttribute::OUTPUT) {
+      return true;
+    }
+    for (const auto& consumer : src_graph->GetConsumersOp(t)) {
+      if (!IsCollapsible(consumer)) {
+        return true;
+      }
+    }
+    return false;
+  };
+
+  std::shared_ptr<vx::Graph> dst_graph = ctx->CreateGraph();
+  graph_utils::TensorMap tensor_map;
+  ReshapeSimplificationReport simplification;
+  std::unordered_map<const vx::Tensor*, std::shared_ptr<vx::Tensor>> roots;
+  for (const auto& op : ops) {
+    if (!IsCollapsible(op)) {
+      graph_utils::CloneOperation(op, dst_graph, tensor_map);
+      continue;
+    }
+    const auto& input = op->impl()->InputsTensor()[0];
+    const auto& output = op->impl()->OutputsTensor()[0];
+    auto it = roots.find(input.get());
+    const auto& root = it != roots.end() ? it->second : input;
+    roots[output.get()] = root;
+
+    if (!needs_output(output)) {
+      VSILOGD("Collapse shape-only op %d", op->impl()->kind_);
+      simplification.collapsed_ops++;
+      if (output->GetSpec().attr_ == vx::TensorAttribute::TRANSIENT) {
+        simplification.saved_bytes += output->GetSpec().GetByteSize();
+      }
+      continue;
+    }
+    auto mapped_root = graph_utils::MapTensor(root, dst_graph, tensor_map);
+    if (root->GetShape() == output->GetShape() &&
+        !(output->GetSpec().attr_ & vx::TensorAttribute::OUTPUT)) {
+      VSILOGD("Remove identity shape-only op %d", op->impl()->kind_);
+      simplification.removed_identities++;
+      if (output->GetSpec().attr_ == vx::TensorAttribute::TRANSIENT) {
+        simplification.saved_bytes += output->GetSpec().GetByteSize();
+      }
+      tensor_map[output] = mapped_root;
+      continue;
+    }
+    dst_graph->CreateOperation<vx::ops::Reshape>(output->GetShape())
+        ->BindInput(mapped_root)
+        .BindOutput(graph_utils::MapTensor(output, dst_graph, tensor_map));
+  }
+  if (report) {
+    *report = simplification;
+  }
+
+  return std::make_pair(dst_graph,
+                        graph_utils::GraphIoMap(src_graph, tensor_map));
+}
+
+}  // namespace transform
+}  // namespace tim
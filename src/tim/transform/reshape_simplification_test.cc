@@ -0,0 +1,140 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops.h"
+#include "tim/transform/layout_inference.h"
+#include "tim/transform/reshape_simplification.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+
+TEST(ReshapeSimplification, identity_reshape) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType shape({2, 2});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto input = src_graph->CreateTensor(input_spec);
+  auto relu = src_graph->CreateTensor(transient_spec);
+  auto reshaped = src_graph->CreateTensor(transient_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(input).BindOutput(relu);
+  src_graph->CreateOperation<tim::vx::ops::Reshape>(std::vector<uint32_t>({2, 2}))
+      ->BindInput(relu)
+      .BindOutput(reshaped);
+  src_graph->CreateOperation<tim::vx::ops::Neg>()->BindInput(reshaped).BindOutput(output);
+
+  tim::transform::ReshapeSimplificationReport report;
+  auto transform = tim::transform::SimplifyReshapes(src_graph, ctx, &report);
+  auto dst_graph = transform.first;
+  auto graph_io_map = transform.second;
+  EXPECT_EQ(report.collapsed_ops, 0);
+  EXPECT_EQ(report.removed_identities, 1);
+  EXPECT_EQ(report.saved_bytes, 4 * sizeof(float));
+
+  EXPECT_TRUE(dst_graph->Compile());
+  std::vector<float> in_data = {1.0f, -2.0f, 3.0f, -4.0f};
+  graph_io_map[input]->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float));
+  EXPECT_TRUE(dst_graph->Run());
+
+  std::vector<float> out_data(4);
+  EXPECT_TRUE(graph_io_map[output]->CopyDataFromTensor(out_data.data()));
+  std::vector<float> expect_output = {-1.0f, 0.0f, -3.0f, 0.0f};
+  EXPECT_EQ(out_data, expect_output);
+}
+
+TEST(ReshapeSimplification, chain_after_permuted_conv) {
+  auto ctx = tim::vx::Context::Create();
+  auto src_graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType conv_shape({2, 2, 2, 1});
+  tim::vx::ShapeType flat_shape({8, 1});
+  tim::vx::ShapeType out_shape({2, 4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, conv_shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec conv_spec(tim::vx::DataType::FLOAT32, conv_shape,
+                                tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec flat_spec(tim::vx::DataType::FLOAT32, flat_shape,
+                                tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec reshaped_spec(tim::vx::DataType::FLOAT32, out_shape,
+                                    tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, out_shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto input = src_graph->CreateTensor(input_spec);
+  auto conv_out = src_graph->CreateTensor(conv_spec);
+  auto flat = src_graph->CreateTensor(flat_spec);
+  auto reshaped = src_graph->CreateTensor(reshaped_spec);
+  auto same = src_graph->CreateTensor(reshaped_spec);
+  auto output = src_graph->CreateTensor(output_spec);
+
+  // A CWHN pointwise conv swapping the two channels, LayoutInference
+  // leaves its output permuted for the reshapes to deal with
+  std::vector<float> weight_data = {0.0f, 1.0f, 1.0f, 0.0f};
+  std::vector<float> bias_data = {0.0f, 0.0f};
+  auto weight = src_graph->CreateTensor(
+      tim::vx::TensorSpec(tim::vx::DataType::FLOAT32, {2, 1, 1, 2},
+                          tim::vx::TensorAttribute::CONSTANT),
+      weight_data.data());
+  auto bias = src_graph->CreateTensor(
+      tim::vx::TensorSpec(tim::vx::DataType::FLOAT32, {2},
+                          tim::vx::TensorAttribute::CONSTANT),
+      bias_data.data());
+  src_graph->CreateOperation<tim::vx::ops::Conv2d>(
+      2, tim::vx::PadType::VALID, std::array<uint32_t, 2>({1, 1}),
+      std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}), 0,
+      tim::vx::DataLayout::CWHN, tim::vx::DataLayout::IcWHOc)
+      ->BindInputs({input, weight, bias})
+      .BindOutput(conv_out);
+  src_graph->CreateOperation<tim::vx::ops::Reshape>(flat_shape)
+      ->BindInput(conv_out)
+      .BindOutput(flat);
+  src_graph->CreateOperation<tim::vx::ops::Reshape>(out_shape)
+      ->BindInput(flat)
+      .BindOutput(reshaped);
+  src_graph->CreateOperation<tim::vx::ops::Reshape>(out_shape)
+      ->BindInput(reshaped)
+      .BindOutput(same);
+  src_graph->CreateOperation<tim::vx::ops::Relu>()->BindInput(same).BindOutput(output);
+
+  tim::transform::ReshapeSimplificationReport report;
+  auto simplified = tim::transform::SimplifyReshapes(src_graph, ctx, &report);
+  EXPECT_EQ(report.collapsed_ops, 2);
+  EXPECT_EQ(report.removed_identities, 0);
+  EXPECT_EQ(report.saved_bytes, 2 * 8 * sizeof(float));
+
+  // Swapping channels flips the lowest index bit
+  std::vector<float> in_data(8), expect_output(8);
+  for (int i = 0; i < 8; ++i) {
+    in_data[i] = static_cast<float>(i - 4);
+    expect_output[i] = std::max(0.0f, static_cast<float>((i ^ 1) - 4));
+  }
+
+  // Before and after LayoutInference give the source layout result
+  auto infer = tim::transform::LayoutInference(simplified.first, ctx);
+  auto run_and_check = [&](std::shared_ptr<tim::vx::Graph> graph,
+                           std::shared_ptr<tim::vx::Tensor> graph_input,
+                           std::shared_ptr<tim::vx::Tensor> graph_output) {
+    EXPECT_TRUE(graph->Compile());
+    graph_input->CopyDataToTensor(in_data.data(),
+                                  in_data.size() * sizeof(float));
+    EXPECT_TRUE(graph->Run());
+    std::vector<float> out_data(8);
+    EXPECT_TRUE(graph_output->CopyDataFromTensor(out_data.data()));
+    EXPECT_EQ(out_data, expect_output);
+  };
+  run_and_check(infer.first, infer.second[simplified.second[input]],
+                infer.second[simplified.second[output]]);
+
+  auto inferred_first = tim::transform::LayoutInference(src_graph, ctx);
+  auto simplified_after =
+      tim::transform::SimplifyReshapes(inferred_first.first, ctx);
+  run_and_check(simplified_after.first,
+                simplified_after.second[inferred_first.second[input]],
+                simplified_after.second[inferred_first.second[output]]);
+}
@@ -44,7 +44,7 @@ BuiltinOpImpl& BuiltinOpImpl::BindInput(
     const std::shared_ptr<Tensor>& tensor) {
   inputs_tensor_.push_back(tensor);
   uint32_t tensor_id = tensor->GetId();
-  node_->input.tensors[input_tensor_index++] = tensor_id;
+  vsi_nn_SetNodeInput(node_, input_tensor_index++, tensor_id);
   if (tensor->GetSpec().attr_ & TensorAttribute::INPUT) {
     graph_->AddInput(tensor_id);
     graph_->AddInput(tensor);
@@ -56,7 +56,7 @@ BuiltinOpImpl& BuiltinOpImpl::BindOutput(
     const std::shared_ptr<Tensor>& tensor) {
   outputs_tensor_.push_back(tensor);
   uint32_t tensor_id = tensor->GetId();
-  node_->output.tensors[output_tensor_index++] = tensor_id;
+  vsi_nn_SetNodeOutput(node_, output_tensor_index++, tensor_id);
   if (tensor->GetSpec().attr_ == TensorAttribute::OUTPUT) {
     graph_->AddOutput(tensor_id);
     graph_->AddOutput(tensor);
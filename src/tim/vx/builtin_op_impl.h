@@ -51,10 +51,10 @@ class BuiltinOpImpl : public OpImpl {
       RoundType down_scale_size_rounding = RoundType::FLOOR,
       uint32_t accumulator_bits = 0) override;
 
-  std::vector<std::shared_ptr<Tensor>> InputsTensor() override {
+  const std::vector<std::shared_ptr<Tensor>>& InputsTensor() override {
     return inputs_tensor_;
   }
-  std::vector<std::shared_ptr<Tensor>> OutputsTensor() override {
+  const std::vector<std::shared_ptr<Tensor>>& OutputsTensor() override {
     return outputs_tensor_;
   }
 
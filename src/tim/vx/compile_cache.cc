@@ -0,0 +1,162 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "compile_cache.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <tuple>
+
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+namespace {
+
+const char kSuffix[] = ".nbg";
+
+bool HasSuffix(const std::string& name, const std::string& suffix) {
+  return name.size() > suffix.size() &&
+         0 == name.compare(name.size() - suffix.size(), suffix.size(), suffix);
+}
+
+}  // namespace
+
+CompileCache::CompileCache(const std::string& dir, uint64_t size_limit)
+    : dir_(dir), size_limit_(size_limit) {}
+
+std::string CompileCache::PathOf(const std::string& key) const {
+  return dir_ + "/" + key + kSuffix;
+}
+
+bool CompileCache::Load(const std::string& key, std::vector<char>& nbg) const {
+  std::string path = PathOf(key);
+  FILE* fp = fopen(path.c_str(), "rb");
+  if (!fp) {
+    return false;
+  }
+
+  bool status = false;
+  if (0 == fseek(fp, 0, SEEK_END)) {
+    long size = ftell(fp);
+    if (size > 0 && 0 == fseek(fp, 0, SEEK_SET)) {
+      nbg.resize(static_cast<size_t>(size));
+      status = (nbg.size() == fread(nbg.data(), 1, nbg.size(), fp));
+    }
+  }
+  fclose(fp);
+
+  if (status) {
+    // Refresh mtime so eviction keeps recently used graphs
+    utime(path.c_str(), nullptr);
+  } else {
+    VSILOGW("Read compile cache %s fail", path.c_str());
+    nbg.clear();
+  }
+  return status;
+}
+
+bool CompileCache::Store(const std::string& key,
+                         const std::vector<char>& nbg) const {
+  static std::atomic<uint32_t> sequence{0};
+
+  if (nbg.empty()) {
+    return false;
+  }
+  mkdir(dir_.c_str(), 0755);
+
+  // Write a private temporary file, then publish it with rename(2) so that
+  // concurrent readers never see a partial graph.
+  std::string path = PathOf(key);
+  std::string tmp_path = path + ".tmp." + std::to_string(getpid()) + "." +
+                         std::to_string(sequence++);
+  FILE* fp = fopen(tmp_path.c_str(), "wb");
+  if (!fp) {
+    VSILOGW("Create compile cache %s fail", tmp_path.c_str());
+    return false;
+  }
+  bool status = (nbg.size() == fwrite(nbg.data(), 1, nbg.size(), fp)) &&
+                (0 == fflush(fp)) && (0 == fsync(fileno(fp)));
+  status = (0 == fclose(fp)) && status;
+  status = status && (0 == rename(tmp_path.c_str(), path.c_str()));
+  if (!status) {
+    VSILOGW("Write compile cache %s fail", path.c_str());
+    unlink(tmp_path.c_str());
+    return false;
+  }
+
+  Evict(path);
+  return true;
+}
+
+void CompileCache::Evict(const std::string& keep) const {
+  if (0 == size_limit_) {
+    return;
+  }
+  DIR* dir = opendir(dir_.c_str());
+  if (!dir) {
+    return;
+  }
+
+  // (mtime, size, path) of every cached graph
+  std::vector<std::tuple<time_t, uint64_t, std::string>> entries;
+  uint64_t total = 0;
+  while (struct dirent* entry = readdir(dir)) {
+    std::string name(entry->d_name);
+    if (!HasSuffix(name, kSuffix)) {
+      continue;
+    }
+    std::string path = dir_ + "/" + name;
+    struct stat st;
+    if (0 == stat(path.c_str(), &st) && S_ISREG(st.st_mode)) {
+      entries.emplace_back(st.st_mtime, static_cast<uint64_t>(st.st_size),
+                           path);
+      total += st.st_size;
+    }
+  }
+  closedir(dir);
+
+  std::sort(entries.begin(), entries.end());
+  for (auto& entry : entries) {
+    if (total <= size_limit_) {
+      break;
+    }
+    if (std::get<2>(entry) == keep) {
+      continue;
+    }
+    if (0 == unlink(std::get<2>(entry).c_str())) {
+      total -= std::get<1>(entry);
+    }
+  }
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,55 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_COMPILE_CACHE_H_
+#define TIM_VX_COMPILE_CACHE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace tim {
+namespace vx {
+
+/// Directory of compiled graphs (NBG), one `<key>.nbg` file per graph.
+/// Files are published with an atomic rename, and the least recently used
+/// ones are removed once the directory grows beyond `size_limit` bytes.
+class CompileCache {
+ public:
+  CompileCache(const std::string& dir, uint64_t size_limit);
+
+  bool Load(const std::string& key, std::vector<char>& nbg) const;
+  bool Store(const std::string& key, const std::vector<char>& nbg) const;
+
+ private:
+  std::string PathOf(const std::string& key) const;
+  void Evict(const std::string& keep) const;
+
+  std::string dir_;
+  uint64_t size_limit_;
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_COMPILE_CACHE_H_ */
@@ -47,6 +47,8 @@ struct CompileOptionImpl {
   }
 
   RelaxModeType relax_mode_;
+  std::string cache_dir_;
+  uint64_t cache_size_limit_{512 * 1024 * 1024};
 };
 
 CompileOption::CompileOption() : impl_(new CompileOptionImpl()) {}
@@ -56,5 +58,21 @@ bool CompileOption::isRelaxMode() const { return this->impl_->RelaxMode(); }
 bool CompileOption::setRelaxMode(bool enable) {
   return this->impl_->RelaxMode() = enable;
 }
+
+const std::string& CompileOption::getCacheDir() const {
+  return this->impl_->cache_dir_;
+}
+
+const std::string& CompileOption::setCacheDir(const std::string& dir) {
+  return this->impl_->cache_dir_ = dir;
+}
+
+uint64_t CompileOption::getCacheSizeLimit() const {
+  return this->impl_->cache_size_limit_;
+}
+
+uint64_t CompileOption::setCacheSizeLimit(uint64_t bytes) {
+  return this->impl_->cache_size_limit_ = bytes;
+}
 }  // namespace vx
 }  // namespace tim
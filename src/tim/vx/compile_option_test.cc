@@ -33,4 +33,15 @@ TEST(compile_option, relax_mode) {
   EXPECT_TRUE(opt.isRelaxMode() == true);
 
   EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions.isRelaxMode() == false);
-}
\ No newline at end of file
+}
+TEST(compile_option, cache) {
+  tim::vx::CompileOption opt;
+
+  EXPECT_TRUE(opt.getCacheDir().empty());
+  opt.setCacheDir("/tmp/tim_vx_cache");
+  EXPECT_EQ(opt.getCacheDir(), "/tmp/tim_vx_cache");
+  opt.setCacheSizeLimit(1024);
+  EXPECT_EQ(opt.getCacheSizeLimit(), 1024u);
+
+  EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions.getCacheDir().empty());
+}
@@ -23,10 +23,20 @@
 *****************************************************************************/
 #include "tim/vx/graph.h"
 #include <algorithm>
-
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "builtin_op_impl.h"
+#include "compile_cache.h"
+#include "kernel/vsi_nn_kernel.h"
 #include "context_private.h"
 #include "graph_private.h"
+#include "hash_utils.h"
 #include "op_impl.h"
+#include "param_utils.h"
 #include "tensor_private.h"
 #include "tim/vx/context.h"
 #include "tim/vx/ops/nbg.h"
@@ -51,7 +61,25 @@ GraphImpl::GraphImpl(ContextImpl* context, const CompileOption& options)
       tensor_placeholder_(nullptr),
       options_(options){}
 
-GraphImpl::~GraphImpl() { vsi_nn_ReleaseGraph(&graph_); }
+GraphImpl::~GraphImpl() {
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    async_exit_ = true;
+  }
+  async_cv_.notify_all();
+  if (async_worker_.joinable()) {
+    async_worker_.join();
+  }
+  // Hand the tensors their own handles back, releasing the graph frees
+  // whatever handle is swapped in at that point.
+  for (auto& binding : input_bindings_) {
+    ReleaseBinding(binding);
+  }
+  for (auto& binding : output_bindings_) {
+    ReleaseBinding(binding);
+  }
+  vsi_nn_ReleaseGraph(&graph_);
+}
 
 vsi_nn_graph_t* GraphImpl::graph() { return graph_; }
 
@@ -90,21 +118,106 @@ const std::vector<std::shared_ptr<Tensor>> GraphImpl::OutputsTensor() const {
 }
 
 void GraphImpl::UpdateTensorConsumersMap(const std::shared_ptr<Tensor>& tensor,
-                                         const Operation* op) {
-  for (const auto& added_op : op_vector_) {
-    if (added_op.get() == op) {
-      tensor_consumers_[tensor].push_back(added_op);
+                                         const std::shared_ptr<Operation>& op) {
+  tensor_consumers_[tensor].push_back(op);
+  FingerprintBind(tensor, op, false);
+}
+
+void GraphImpl::UpdateTensorProducerMap(const std::shared_ptr<Tensor>& tensor,
+                                        const std::shared_ptr<Operation>& op) {
+  tensor_producer_[tensor] = op;
+  FingerprintBind(tensor, op, true);
+}
+
+void GraphImpl::FingerprintBind(const std::shared_ptr<Tensor>& tensor,
+                                const std::shared_ptr<Operation>& op,
+                                bool is_output) {
+  // Ops and tensors are numbered by first use, so equal build sequences
+  // give equal fingerprints no matter where objects live in memory.
+  auto op_entry = fingerprint_ops_.emplace(op.get(), fingerprint_ops_.size());
+  structure_hasher_.Update(op_entry.first->second);
+  if (op_entry.second) {
+    auto& impl = op->impl();
+    structure_hasher_.Update(impl->kind_).Update(impl->layout_);
+    if (vsi_nn_node_t* node = impl->node()) {
+      if (!FingerprintParam(impl.get(), node)) {
+        cacheable_ = false;
+      }
     }
   }
+
+  auto tensor_entry =
+      fingerprint_tensors_.emplace(tensor.get(), fingerprint_tensors_.size());
+  structure_hasher_.Update(is_output).Update(tensor_entry.first->second);
+  if (!tensor_entry.second || tensor->IsPlaceHolder()) {
+    return;
+  }
+  TensorSpec& spec = tensor->GetSpec();
+  structure_hasher_.Update(spec.datatype_).Update(spec.attr_);
+  structure_hasher_.Update(spec.shape_.size())
+      .Update(spec.shape_.data(), spec.shape_.size() * sizeof(uint32_t));
+  Quantization& quant = spec.quantization_;
+  structure_hasher_.Update(quant.Type())
+      .Update(quant.ChannelDim())
+      .Update(quant.Fl());
+  structure_hasher_.Update(quant.Scales().size())
+      .Update(quant.Scales().data(), quant.Scales().size() * sizeof(float));
+  structure_hasher_.Update(quant.ZeroPoints().size())
+      .Update(quant.ZeroPoints().data(),
+              quant.ZeroPoints().size() * sizeof(int32_t));
+  if (tensor->IsConstTensor() && tensor->GetDataRef()) {
+    fingerprint_constants_.emplace_back(tensor_entry.first->second, tensor);
+  }
 }
 
-void GraphImpl::UpdateTensorProducerMap(const std::shared_ptr<Tensor>& tensor,
-                                         const Operation* op) {
-  for (const auto& added_op : op_vector_) {
-    if (added_op.get() == op) {
-      tensor_producer_[tensor] = added_op;
+bool GraphImpl::FingerprintParam(const OpImpl* impl,
+                                 const vsi_nn_node_t* node) {
+#ifdef TIM_VX_ENABLE_CUSTOM_OP
+  // Parameters of custom ops live in the user's op object
+  if (dynamic_cast<const CustomOpBaseImpl*>(impl)) {
+    return false;
+  }
+#else
+  (void)impl;
+#endif
+  // The url points at a binary of unknown size
+  if (VSI_NN_OP_NBG == node->op) {
+    return false;
+  }
+
+  // Pointers differ between runs and may be reused within one, hash what
+  // they point at instead.
+  for (const auto& array : ParamArrays(node)) {
+    structure_hasher_.Update(array.bytes);
+    if (array.bytes > 0) {
+      structure_hasher_.Update(array.data, array.bytes);
     }
   }
+  structure_hasher_.Update(ComparableParam(node)).Update(node->vx_param);
+  return true;
+}
+
+std::array<uint64_t, 2> GraphImpl::Fingerprint(bool with_constants) {
+  if (!with_constants) {
+    return structure_hasher_.Final();
+  }
+  // Payloads are only hashed when asked for, once each. ovxlib copied them
+  // when the tensor was created and the caller may have freed its buffer
+  // since, so they are read back from the graph.
+  std::vector<uint8_t> payload;
+  for (; hashed_constants_ < fingerprint_constants_.size();
+       ++hashed_constants_) {
+    auto& constant = fingerprint_constants_[hashed_constants_];
+    payload.resize(constant.second->GetSpec().GetByteSize());
+    if (!constant.second->CopyDataFromTensor(payload.data())) {
+      VSILOGW("Read constant %u for the fingerprint fail", constant.first);
+    }
+    constant_hasher_.Update(constant.first)
+        .Update(payload.data(), payload.size());
+  }
+  Hasher128 hasher;
+  hasher.Update(structure_hasher_.Final()).Update(constant_hasher_.Final());
+  return hasher.Final();
 }
 
 const std::vector<std::shared_ptr<Operation>> GraphImpl::GetConsumersOp(
@@ -154,22 +267,15 @@ std::shared_ptr<Tensor> GraphImpl::CreateTensorPlaceHolder() {
   return tensor_placeholder_;
 }
 
+std::shared_ptr<Tensor> GraphImpl::CreateOwnedTensor(
+    const TensorSpec& spec, std::vector<uint8_t> data) {
+  owned_data_.push_back(std::move(data));
+  return CreateTensor(spec, owned_data_.back().data());
+}
+
 bool GraphImpl::Setup() {
   bool status = true;
 
-  auto major = vsi_nn_GetVersionMajor();
-  auto minor = vsi_nn_GetVersionMinor();
-  auto patch = vsi_nn_GetVersionPatch();
-
-  vsi_nn_SetGraphVersion(graph_, major, minor, patch);
-
-  bool is_fast_mode = options_.isRelaxMode();
-  if (is_fast_mode) {
-    VSILOGW("Important notice: float model executed in bfloat16 "
-            "mode which will have better performance but lower precesion");
-  }
-  vsi_nn_SetGraphFastMode(graph_, is_fast_mode);
-
   std::call_once(setio_once_, [&status, this]() {
     status = (vsi_nn_SetGraphInputs(this->graph_, this->inputs_.data(),
                                     this->inputs_.size()) &&
@@ -177,7 +283,22 @@ bool GraphImpl::Setup() {
                                      this->outputs_.size()));
   });
 
+  // Graph attributes are only set once too, Submit() compiles again while
+  // the async worker may be running the graph
   std::call_once(setup_once_, [&status, this]() {
+    auto major = vsi_nn_GetVersionMajor();
+    auto minor = vsi_nn_GetVersionMinor();
+    auto patch = vsi_nn_GetVersionPatch();
+
+    vsi_nn_SetGraphVersion(this->graph_, major, minor, patch);
+
+    bool is_fast_mode = this->options_.isRelaxMode();
+    if (is_fast_mode) {
+      VSILOGW("Important notice: float model executed in bfloat16 "
+              "mode which will have better performance but lower precesion");
+    }
+    vsi_nn_SetGraphFastMode(this->graph_, is_fast_mode);
+
     status = (VSI_SUCCESS == vsi_nn_SetupGraph(this->graph_, true));
   });
   return status;
@@ -186,20 +307,459 @@ bool GraphImpl::Setup() {
 bool GraphImpl::Compile() {
   bool status = true;
 
+  if (!options_.getCacheDir().empty() && !profiling_ && cacheable_) {
+    std::call_once(compile_cache_once_,
+                   [this]() { this->LoadFromCompileCache(); });
+    if (nbg_graph_) {
+      return true;
+    }
+  }
+
   status = Setup();
   std::call_once(verify_graph_once_, [&status, this]() {
+    if (status && !this->options_.getCacheDir().empty() &&
+        !this->profiling_ && this->cacheable_) {
+      this->StoreToCompileCache();
+    }
     status = (VSI_SUCCESS == vsi_nn_VerifyGraph(this->graph_));
   });
 
   return status;
 }
 
+std::string GraphImpl::CompileCacheKey() {
+  Hasher128 hasher;
+
+  // Driver and runtime, a cached graph is only valid for the same stack
+  vsi_nn_context_t ctx = context_->context();
+  vx_uint16 vx_version = 0;
+  vx_char vx_impl[VX_MAX_IMPLEMENTATION_NAME] = {0};
+  vxQueryContext(ctx->c, VX_CONTEXT_VERSION, &vx_version, sizeof(vx_version));
+  vxQueryContext(ctx->c, VX_CONTEXT_IMPLEMENTATION, vx_impl, sizeof(vx_impl));
+  hasher.Update(vx_version).Update(vx_impl, sizeof(vx_impl));
+  hasher.Update(std::string(vsi_nn_GetVersion()));
+  hasher.Update(ctx->config.target_name, sizeof(ctx->config.target_name));
+  hasher.Update(ctx->config.evis.ver).Update(ctx->options);
+  hasher.Update(options_.isRelaxMode());
+
+  hasher.Update(Fingerprint(true));
+  return Hasher128::ToHex(hasher.Final());
+}
+
+bool GraphImpl::LoadFromCompileCache() {
+  compile_cache_key_ = CompileCacheKey();
+  CompileCache cache(options_.getCacheDir(), options_.getCacheSizeLimit());
+  std::vector<char> nbg;
+  if (!cache.Load(compile_cache_key_, nbg)) {
+    return false;
+  }
+
+  // The cached graph reads and writes the handles of our own io tensors,
+  // so the user facing tensors keep working without extra copies.
+  auto nbg_graph = std::make_shared<GraphImpl>(context_);
+  auto mirror = [this, &nbg_graph](const std::shared_ptr<Tensor>& tensor) {
+    vsi_nn_tensor_t* t = vsi_nn_GetTensor(graph_, tensor->GetId());
+    void* handle = nullptr;
+    if (!t || VSI_SUCCESS != vsi_nn_GetTensorHandle(t, &handle) || !handle) {
+      return std::shared_ptr<Tensor>();
+    }
+    return nbg_graph->CreateIOTensor(tensor->GetSpec(), handle);
+  };
+  std::vector<std::shared_ptr<Tensor>> nbg_inputs;
+  std::vector<std::shared_ptr<Tensor>> nbg_outputs;
+  for (const auto& tensor : inputs_tensor_) {
+    nbg_inputs.push_back(mirror(tensor));
+  }
+  for (const auto& tensor : outputs_tensor_) {
+    nbg_outputs.push_back(mirror(tensor));
+  }
+  if (std::find(nbg_inputs.begin(), nbg_inputs.end(), nullptr) !=
+          nbg_inputs.end() ||
+      std::find(nbg_outputs.begin(), nbg_outputs.end(), nullptr) !=
+          nbg_outputs.end()) {
+    VSILOGW("Map io tensors for compile cache fail, recompile graph");
+    return false;
+  }
+
+  nbg_buffer_ = std::move(nbg);
+  nbg_graph
+      ->CreateOperation<ops::NBG>(nbg_buffer_.data(), nbg_inputs.size(),
+                                  nbg_outputs.size())
+      ->BindInputs(nbg_inputs)
+      .BindOutputs(nbg_outputs);
+  if (!nbg_graph->Compile()) {
+    VSILOGW("Load compile cache %s fail, recompile graph",
+            compile_cache_key_.c_str());
+    nbg_buffer_.clear();
+    return false;
+  }
+  nbg_graph_ = nbg_graph;
+  return true;
+}
+
+void GraphImpl::StoreToCompileCache() {
+  size_t size = 0;
+  if (VSI_SUCCESS != vsi_nn_GenerateNBG(graph_, nullptr, &size) || 0 == size) {
+    VSILOGW("Generate NBG for compile cache fail");
+    return;
+  }
+  std::vector<char> nbg(size);
+  if (VSI_SUCCESS != vsi_nn_GenerateNBG(graph_, nbg.data(), &size)) {
+    VSILOGW("Generate NBG for compile cache fail");
+    return;
+  }
+  nbg.resize(size);
+  CompileCache cache(options_.getCacheDir(), options_.getCacheSizeLimit());
+  cache.Store(compile_cache_key_, nbg);
+}
+
 bool GraphImpl::CompileToBinary(void* buf, size_t* size) {
   return ((Setup()) && (VSI_SUCCESS == vsi_nn_GenerateNBG(graph_, buf, size)));
 }
 
 bool GraphImpl::Run() {
-  return ((Compile()) && (VSI_SUCCESS == vsi_nn_RunGraph(graph_)));
+  return WaitAsyncIdle() && Compile() && Execute(nullptr, nullptr, false);
+}
+
+bool GraphImpl::Run(const std::vector<const void*>& inputs,
+                    const std::vector<void*>& outputs) {
+  return WaitAsyncIdle() && Compile() && CheckIo(inputs, outputs) &&
+         Execute(&inputs, &outputs, false);
+}
+
+std::future<bool> GraphImpl::RunAsync(RunCallback callback) {
+  std::unique_ptr<AsyncRun> run(new AsyncRun());
+  run->callback = std::move(callback);
+  return Submit(std::move(run));
+}
+
+std::future<bool> GraphImpl::RunAsync(const std::vector<const void*>& inputs,
+                                      const std::vector<void*>& outputs,
+                                      RunCallback callback) {
+  std::unique_ptr<AsyncRun> run(new AsyncRun());
+  run->bind = true;
+  run->inputs = inputs;
+  run->outputs = outputs;
+  run->callback = std::move(callback);
+  return Submit(std::move(run));
+}
+
+void GraphImpl::SetMaxInFlight(uint32_t count) {
+  std::lock_guard<std::mutex> lock(async_mutex_);
+  max_in_flight_ = std::max(count, 1u);
+  async_cv_.notify_all();
+}
+
+void GraphImpl::EnableProfiling(bool enable) {
+  if (enable && !profiling_) {
+    vxDirective(reinterpret_cast<vx_reference>(context_->context()->c),
+                VX_DIRECTIVE_ENABLE_PERFORMANCE);
+  }
+  profiling_ = enable;
+}
+
+GraphProfile GraphImpl::GetProfile() {
+  std::lock_guard<std::mutex> lock(profile_mutex_);
+  return profile_;
+}
+
+MemoryReport GraphImpl::GetMemoryReport() {
+  MemoryReport report;
+  const vsi_nn_memory_plan_t* planned = vsi_nn_GetGraphMemoryPlan(graph_);
+  if (planned == nullptr) {
+    VSILOGE("Plan graph memory fail");
+    return report;
+  }
+  const vsi_nn_memory_plan_t& plan = *planned;
+  for (uint32_t i = 0; i < plan.block_num; ++i) {
+    const vsi_nn_memory_block_t& block = plan.blocks[i];
+    report.blocks.push_back({block.tensor, block.first, block.last,
+                             block.size, block.offset});
+  }
+  report.total_bytes = plan.total_bytes;
+  report.peak_bytes = plan.peak_bytes;
+  report.arena_bytes = plan.arena_bytes;
+  return report;
+}
+
+bool GraphImpl::CheckIo(const std::vector<const void*>& inputs,
+                        const std::vector<void*>& outputs) {
+  if (inputs.size() != inputs_tensor_.size() ||
+      outputs.size() != outputs_tensor_.size()) {
+    VSILOGE("Expect %zu inputs and %zu outputs, but got %zu and %zu",
+            inputs_tensor_.size(), outputs_tensor_.size(), inputs.size(),
+            outputs.size());
+    return false;
+  }
+  return true;
+}
+
+std::future<bool> GraphImpl::Submit(std::unique_ptr<AsyncRun> run) {
+  auto future = run->promise.get_future();
+  auto fail = [&run]() {
+    if (run->callback) {
+      run->callback(false);
+    }
+    run->promise.set_value(false);
+  };
+  if (!Compile() ||
+      (run->bind && !CheckIo(run->inputs, run->outputs))) {
+    fail();
+    return future;
+  }
+
+  std::unique_lock<std::mutex> lock(async_mutex_);
+  if (!async_worker_.joinable()) {
+    async_worker_ = std::thread(&GraphImpl::AsyncWorker, this);
+  }
+  // A callback waiting for a slot would wait for its own run to end
+  if (std::this_thread::get_id() == async_worker_.get_id() &&
+      async_pending_ >= max_in_flight_) {
+    lock.unlock();
+    VSILOGE("RunAsync from a run callback with %u runs in flight",
+            max_in_flight_);
+    fail();
+    return future;
+  }
+  // Back-pressure: the caller waits for a free slot
+  async_cv_.wait(lock, [this]() { return async_pending_ < max_in_flight_; });
+  async_queue_.push_back(std::move(run));
+  ++async_pending_;
+  async_cv_.notify_all();
+  return future;
+}
+
+void GraphImpl::AsyncWorker() {
+  std::unique_lock<std::mutex> lock(async_mutex_);
+  while (true) {
+    async_cv_.wait(lock,
+                   [this]() { return async_exit_ || !async_queue_.empty(); });
+    if (async_queue_.empty()) {
+      return;
+    }
+    auto run = std::move(async_queue_.front());
+    async_queue_.pop_front();
+    lock.unlock();
+
+    bool status = run->bind ? Execute(&run->inputs, &run->outputs, true)
+                            : Execute(nullptr, nullptr, true);
+    if (run->callback) {
+      run->callback(status);
+    }
+    run->promise.set_value(status);
+
+    lock.lock();
+    --async_pending_;
+    async_cv_.notify_all();
+  }
+}
+
+bool GraphImpl::WaitAsyncIdle() {
+  std::unique_lock<std::mutex> lock(async_mutex_);
+  if (std::this_thread::get_id() == async_worker_.get_id()) {
+    VSILOGE("Run from a run callback would wait for the callback itself");
+    return false;
+  }
+  async_cv_.wait(lock, [this]() { return 0 == async_pending_; });
+  return true;
+}
+
+bool GraphImpl::ProcessGraph(bool async) {
+  auto start = std::chrono::steady_clock::now();
+  bool status;
+  if (async) {
+    status = (VSI_SUCCESS == vsi_nn_AsyncRunGraph(graph_)) &&
+             (VSI_SUCCESS == vsi_nn_AsyncRunWait(graph_));
+  } else {
+    status = (VSI_SUCCESS == vsi_nn_RunGraph(graph_));
+  }
+  if (status && profiling_) {
+    CollectProfile(start, std::chrono::steady_clock::now());
+  }
+  return status;
+}
+
+void GraphImpl::CollectProfile(std::chrono::steady_clock::time_point start,
+                               std::chrono::steady_clock::time_point end) {
+  static const char* kKernelTypes[VSI_NN_KERNEL_TYPE_NUM] = {
+      "CPU", "EVIS", "CL", "VX", "SP"};
+  std::lock_guard<std::mutex> lock(profile_mutex_);
+
+  if (profile_.ops.empty()) {
+    // Composite ops have no node of their own, their parts are listed
+    for (const auto& op : op_vector_) {
+      vsi_nn_node_t* node = op->impl()->node();
+      if (!node) {
+        continue;
+      }
+      OpProfile op_profile;
+      op_profile.op = op;
+      op_profile.name = vsi_nn_OpGetName(node->op);
+      for (int type = 0; type < VSI_NN_KERNEL_TYPE_NUM; ++type) {
+        if (node->kernel_types & (1u << type)) {
+          if (!op_profile.kernel_type.empty()) {
+            op_profile.kernel_type += "|";
+          }
+          op_profile.kernel_type += kKernelTypes[type];
+        }
+      }
+      for (const auto& tensor : op->impl()->inputs_tensor_) {
+        op_profile.input_bytes += tensor->GetSpec().GetByteSize();
+      }
+      for (const auto& tensor : op->impl()->outputs_tensor_) {
+        op_profile.output_bytes += tensor->GetSpec().GetByteSize();
+      }
+      profile_.ops.push_back(std::move(op_profile));
+    }
+  }
+
+  GraphProfile::Run run;
+  run.start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     start.time_since_epoch()).count();
+  run.duration_ns =
+      std::chrono::duration_cast<std::chrono::nanoseconds>(end - start)
+          .count();
+  profile_.runs.push_back(run);
+
+  std::vector<vx_perf_t> perfs(profile_.ops.size());
+  uint64_t first_begin = UINT64_MAX;
+  for (size_t i = 0; i < profile_.ops.size(); ++i) {
+    vsi_nn_GetNodePerf(profile_.ops[i].op->impl()->node(), &perfs[i]);
+    if (perfs[i].beg > 0) {
+      first_begin = std::min<uint64_t>(first_begin, perfs[i].beg);
+    }
+  }
+  // Without driver timestamps, ops are laid out back to back
+  uint64_t offset = 0;
+  for (size_t i = 0; i < profile_.ops.size(); ++i) {
+    OpProfile::Sample sample;
+    sample.duration_ns = perfs[i].tmp;
+    sample.start_ns = perfs[i].beg > 0 ? perfs[i].beg - first_begin : offset;
+    offset = sample.start_ns + sample.duration_ns;
+    profile_.ops[i].samples.push_back(sample);
+  }
+}
+
+bool GraphImpl::Execute(const std::vector<const void*>* inputs,
+                        const std::vector<void*>* outputs, bool async) {
+  if (nbg_graph_) {
+    return nbg_graph_->Execute(inputs, outputs, async);
+  }
+  if (!inputs) {
+    for (auto& binding : input_bindings_) {
+      ReleaseBinding(binding);
+    }
+    for (auto& binding : output_bindings_) {
+      ReleaseBinding(binding);
+    }
+    return ProcessGraph(async);
+  }
+
+  input_bindings_.resize(inputs->size());
+  output_bindings_.resize(outputs->size());
+
+  std::vector<size_t> copied_outputs;
+  for (size_t i = 0; i < inputs->size(); ++i) {
+    // Inputs are only read by the graph, swapping a const buffer is safe
+    void* data = const_cast<void*>((*inputs)[i]);
+    if (!BindHandle(inputs_tensor_[i], input_bindings_[i], data) &&
+        !inputs_tensor_[i]->CopyDataToTensor(data)) {
+      return false;
+    }
+  }
+  for (size_t i = 0; i < outputs->size(); ++i) {
+    if (!BindHandle(outputs_tensor_[i], output_bindings_[i], (*outputs)[i])) {
+      copied_outputs.push_back(i);
+    }
+  }
+
+  if (!ProcessGraph(async)) {
+    return false;
+  }
+
+#ifdef VSI_INVALIDATE_HANDLE_SUPPORT
+  for (auto& binding : output_bindings_) {
+    if (binding.bound) {
+      vsi_nn_InvalidateHandle(vsi_nn_GetTensor(graph_, binding.id));
+    }
+  }
+#endif
+  for (auto i : copied_outputs) {
+    if (!outputs_tensor_[i]->CopyDataFromTensor((*outputs)[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool GraphImpl::BindHandle(const std::shared_ptr<Tensor>& tensor,
+                           HandleBinding& binding, void* data) {
+  uintptr_t alignment = graph_->handle_manager.align_start_size;
+  vsi_nn_tensor_t* t = vsi_nn_GetTensor(graph_, tensor->GetId());
+  if (!t || !t->attr.is_created_from_handle || !data ||
+      reinterpret_cast<uintptr_t>(data) % alignment != 0) {
+    ReleaseBinding(binding);
+    return false;
+  }
+
+  if (binding.bound != data) {
+    // Only swap when the caller hands in a different buffer than last run
+    void* old_ptr = nullptr;
+    if (VSI_SUCCESS != vsi_nn_SwapHandle(t, data, &old_ptr)) {
+      VSILOGE("SwapHandle fail");
+      return false;
+    }
+    if (!binding.bound) {
+      binding.id = tensor->GetId();
+      binding.original = old_ptr;
+    }
+    binding.bound = data;
+  }
+  if (tensor->GetSpec().attr_ & TensorAttribute::INPUT) {
+    vsi_nn_FlushHandle(t);
+  }
+  return true;
+}
+
+void GraphImpl::ReleaseBinding(HandleBinding& binding, bool keep_data) {
+  if (!binding.bound) {
+    return;
+  }
+  vsi_nn_tensor_t* t = vsi_nn_GetTensor(graph_, binding.id);
+  if (t) {
+    vsi_nn_SwapHandle(t, binding.original, nullptr);
+    if (keep_data && binding.original) {
+      memcpy(binding.original, binding.bound,
+             vsi_nn_GetTensorSize(t->attr.size, t->attr.dim_num,
+                                  t->attr.dtype.vx_type));
+      vsi_nn_FlushHandle(t);
+    }
+  }
+  binding.original = nullptr;
+  binding.bound = nullptr;
+}
+
+void GraphImpl::RestoreHandle(vsi_nn_tensor_id_t id) {
+  {
+    // Copies made by Execute() and by run callbacks are on the worker and
+    // own the bindings already, anyone else waits for queued runs first.
+    std::unique_lock<std::mutex> lock(async_mutex_);
+    if (std::this_thread::get_id() != async_worker_.get_id()) {
+      async_cv_.wait(lock, [this]() { return 0 == async_pending_; });
+    }
+  }
+  // The tensor is read or written through its own handle next, carry over
+  // what the last run read and wrote so it does not see stale data.
+  for (auto& binding : input_bindings_) {
+    if (binding.id == id) {
+      ReleaseBinding(binding, true);
+    }
+  }
+  for (auto& binding : output_bindings_) {
+    if (binding.id == id) {
+      ReleaseBinding(binding, true);
+    }
+  }
 }
 
 }  // namespace vx
@@ -26,19 +26,28 @@
 #include "tim/vx/graph.h"
 
 #include <vector>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <utility>
-#include <map>
+#include <unordered_map>
 
 #include "tim/vx/tensor.h"
 #include "tim/vx/compile_option.h"
 #include "context_private.h"
+#include "hash_utils.h"
 
 #include "vsi_nn_pub.h"
 
 namespace tim {
 namespace vx {
 
+class OpImpl;
+
 class GraphImpl : public Graph {
  public:
   GraphImpl(ContextImpl* context, const CompileOption& options = CompileOption::DefaultOptions);
@@ -56,9 +65,9 @@ class GraphImpl : public Graph {
   const std::vector<std::shared_ptr<Tensor>> OutputsTensor() const override;
 
   void UpdateTensorConsumersMap(const std::shared_ptr<Tensor>& tensor,
-                                const Operation* op) override;
+                                const std::shared_ptr<Operation>& op) override;
   void UpdateTensorProducerMap(const std::shared_ptr<Tensor>& tensor,
-                                const Operation* op) override;
+                               const std::shared_ptr<Operation>& op) override;
   const std::vector<std::shared_ptr<Operation>> GetConsumersOp(
       std::shared_ptr<Tensor> tensor) const override;
   std::shared_ptr<Operation> GetProducerOp(
@@ -66,6 +75,8 @@ class GraphImpl : public Graph {
 
   void PrintGraph() const override;
 
+  std::array<uint64_t, 2> Fingerprint(bool with_constants = false) override;
+
   std::shared_ptr<Tensor> CreateTensor(const TensorSpec& spec,
                                        const void* data = nullptr) override;
   std::shared_ptr<Tensor> CreateTensor(const TensorSpec& spec,
@@ -73,10 +84,28 @@ class GraphImpl : public Graph {
   std::shared_ptr<Tensor> CreateIOTensor(const TensorSpec& spec,
                                        void* data = nullptr) override;
   std::shared_ptr<Tensor> CreateTensorPlaceHolder() override;
+  /// Create a constant tensor owning `data`, for constants computed by
+  /// graph transforms. GetDataRef() stays valid as long as the graph.
+  std::shared_ptr<Tensor> CreateOwnedTensor(const TensorSpec& spec,
+                                            std::vector<uint8_t> data);
 
   bool Compile() override;
   bool CompileToBinary(void* buf, size_t* size) override;
   bool Run() override;
+  bool Run(const std::vector<const void*>& inputs,
+           const std::vector<void*>& outputs) override;
+  std::future<bool> RunAsync(RunCallback callback = nullptr) override;
+  std::future<bool> RunAsync(const std::vector<const void*>& inputs,
+                             const std::vector<void*>& outputs,
+                             RunCallback callback = nullptr) override;
+  void SetMaxInFlight(uint32_t count) override;
+  void EnableProfiling(bool enable = true) override;
+  GraphProfile GetProfile() override;
+  MemoryReport GetMemoryReport() override;
+
+  /// Put the tensor's own handle back if a user buffer is bound to it,
+  /// waits for queued async runs unless called from the async worker
+  void RestoreHandle(vsi_nn_tensor_id_t id);
 
  protected:
   ContextImpl* context_;
@@ -89,13 +118,90 @@ class GraphImpl : public Graph {
   std::vector<vsi_nn_tensor_id_t> outputs_;
   std::vector<std::shared_ptr<Tensor>> inputs_tensor_;
   std::vector<std::shared_ptr<Tensor>> outputs_tensor_;
-  std::map<std::shared_ptr<Tensor>, std::vector<std::shared_ptr<Operation>>> tensor_consumers_;
-  std::map<std::shared_ptr<Tensor>, std::shared_ptr<Operation>> tensor_producer_;
+  std::unordered_map<std::shared_ptr<Tensor>,
+                     std::vector<std::shared_ptr<Operation>>>
+      tensor_consumers_;
+  std::unordered_map<std::shared_ptr<Tensor>, std::shared_ptr<Operation>>
+      tensor_producer_;
+
+  /// Fingerprint state, see FingerprintBind()
+  Hasher128 structure_hasher_;
+  Hasher128 constant_hasher_;
+  std::unordered_map<const Operation*, uint32_t> fingerprint_ops_;
+  std::unordered_map<const Tensor*, uint32_t> fingerprint_tensors_;
+  /// Bound constants by fingerprint index, the first hashed_constants_ of
+  /// them are in constant_hasher_
+  std::vector<std::pair<uint32_t, std::shared_ptr<Tensor>>>
+      fingerprint_constants_;
+  size_t hashed_constants_{0};
+  /// False once an op with parameters the fingerprint can not see is bound
+  bool cacheable_{true};
 
   CompileOption options_;
+  std::once_flag compile_cache_once_;
+  std::string compile_cache_key_;
+  /// Compiled graph loaded from the cache, it runs in place of graph_
+  std::vector<char> nbg_buffer_;
+  std::shared_ptr<GraphImpl> nbg_graph_;
+  /// Buffers of the tensors created by CreateOwnedTensor()
+  std::list<std::vector<uint8_t>> owned_data_;
+
  private:
+  struct AsyncRun {
+    bool bind{false};
+    std::vector<const void*> inputs;
+    std::vector<void*> outputs;
+    RunCallback callback;
+    std::promise<bool> promise;
+  };
+
+  struct HandleBinding {
+    vsi_nn_tensor_id_t id{VSI_NN_TENSOR_ID_NA};
+    void* original{nullptr};  // handle owned by the tensor
+    void* bound{nullptr};     // user buffer currently swapped in
+  };
+
  /// Setup graph
   bool Setup();
+  void FingerprintBind(const std::shared_ptr<Tensor>& tensor,
+                       const std::shared_ptr<Operation>& op, bool is_output);
+  bool FingerprintParam(const OpImpl* impl, const vsi_nn_node_t* node);
+  std::string CompileCacheKey();
+  bool LoadFromCompileCache();
+  void StoreToCompileCache();
+  bool CheckIo(const std::vector<const void*>& inputs,
+               const std::vector<void*>& outputs);
+  bool Execute(const std::vector<const void*>* inputs,
+               const std::vector<void*>* outputs, bool async);
+  bool ProcessGraph(bool async);
+  std::future<bool> Submit(std::unique_ptr<AsyncRun> run);
+  void AsyncWorker();
+  /// False, without waiting, when called from the async worker
+  bool WaitAsyncIdle();
+  bool BindHandle(const std::shared_ptr<Tensor>& tensor, HandleBinding& binding,
+                  void* data);
+  /// Swap the tensor's own handle back in, with `keep_data` the bound
+  /// buffer's content is copied into it first
+  void ReleaseBinding(HandleBinding& binding, bool keep_data = false);
+  void CollectProfile(std::chrono::steady_clock::time_point start,
+                      std::chrono::steady_clock::time_point end);
+
+  std::vector<HandleBinding> input_bindings_;
+  std::vector<HandleBinding> output_bindings_;
+
+  /// RunAsync state, guarded by async_mutex_
+  std::mutex async_mutex_;
+  std::condition_variable async_cv_;
+  std::deque<std::unique_ptr<AsyncRun>> async_queue_;
+  uint32_t async_pending_{0};
+  uint32_t max_in_flight_{2};
+  bool async_exit_{false};
+  std::thread async_worker_;
+
+  /// Profiling state, profile_ is guarded by profile_mutex_
+  bool profiling_{false};
+  std::mutex profile_mutex_;
+  GraphProfile profile_;
 };
 
 }  // namespace vx
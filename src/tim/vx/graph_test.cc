@@ -21,13 +21,24 @@
 *    DEALINGS IN THE SOFTWARE.
 *
 *****************************************************************************/
+#include "tim/vx/compile_option.h"
 #include "tim/vx/context.h"
 #include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
 #include "tim/vx/ops/elementwise.h"
 #include "tim/vx/ops/nbg.h"
+#include "tim/vx/ops/transpose.h"
 
 #include "gtest/gtest.h"
 
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
 #include <vector>
 
 TEST(graph, gen_binary_graph_with_empty_graph) {
@@ -90,3 +101,478 @@ TEST(graph, gen_binary_graph_with_simple_add) {
     EXPECT_TRUE(nbg_out->CopyDataFromTensor(&output));
     EXPECT_EQ(output, expected_out);
 }
+
+TEST(graph, tensor_consumers_and_producer) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({1,1,1,1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto mid_t = graph->CreateTensor(transient_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+
+    auto add0 = graph->CreateOperation<tim::vx::ops::Add>();
+    (*add0).BindInputs({input_t, input_t}).BindOutputs({mid_t});
+    auto add1 = graph->CreateOperation<tim::vx::ops::Add>();
+    (*add1).BindInputs({mid_t, input_t}).BindOutputs({output_t});
+
+    auto input_consumers = graph->GetConsumersOp(input_t);
+    ASSERT_EQ(input_consumers.size(), 3u);
+    EXPECT_EQ(input_consumers[0], add0);
+    EXPECT_EQ(input_consumers[1], add0);
+    EXPECT_EQ(input_consumers[2], add1);
+
+    auto mid_consumers = graph->GetConsumersOp(mid_t);
+    ASSERT_EQ(mid_consumers.size(), 1u);
+    EXPECT_EQ(mid_consumers[0], add1);
+
+    EXPECT_EQ(graph->GetProducerOp(mid_t), add0);
+    EXPECT_EQ(graph->GetProducerOp(output_t), add1);
+    EXPECT_EQ(graph->GetProducerOp(input_t), nullptr);
+    EXPECT_TRUE(graph->GetConsumersOp(output_t).empty());
+}
+
+TEST(graph, run_with_user_buffers) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({16});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t0 = graph->CreateTensor(input_spec);
+    auto input_t1 = graph->CreateTensor(input_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+
+    auto add = graph->CreateOperation<tim::vx::ops::Add>();
+    (*add).BindInputs({input_t0, input_t1}).BindOutputs({output_t});
+
+    alignas(64) float in0[2][16];
+    alignas(64) float in1[16];
+    alignas(64) float out[2][16];
+    for (int i = 0; i < 16; ++i) {
+        in0[0][i] = static_cast<float>(i);
+        in0[1][i] = static_cast<float>(2 * i);
+        in1[i] = 1.0f;
+    }
+
+    // zero-copy bindings, the second run rebinds only the changed buffers
+    EXPECT_TRUE(graph->Run({in0[0], in1}, {out[0]}));
+    EXPECT_TRUE(graph->Run({in0[1], in1}, {out[1]}));
+    for (int i = 0; i < 16; ++i) {
+        EXPECT_EQ(out[0][i], in0[0][i] + 1.0f);
+        EXPECT_EQ(out[1][i], in0[1][i] + 1.0f);
+    }
+
+    // the tensor keeps the result of the last run once its handle is back
+    std::vector<float> last(16, 0.0f);
+    EXPECT_TRUE(output_t->CopyDataFromTensor(last.data()));
+    EXPECT_EQ(last[0], out[1][0]);
+    EXPECT_EQ(last[15], out[1][15]);
+
+    // unaligned buffers fall back to copies
+    std::vector<float> unaligned_in(17, 3.0f);
+    std::vector<float> unaligned_out(17, 0.0f);
+    EXPECT_TRUE(graph->Run({unaligned_in.data() + 1, in1},
+                           {unaligned_out.data() + 1}));
+    EXPECT_EQ(unaligned_out[1], 4.0f);
+
+    // the copy path keeps working after user buffers were bound
+    std::vector<float> ones(16, 1.0f);
+    std::vector<float> output(16, 0.0f);
+    EXPECT_TRUE(input_t0->CopyDataToTensor(ones.data(), ones.size() * sizeof(float)));
+    EXPECT_TRUE(input_t1->CopyDataToTensor(ones.data(), ones.size() * sizeof(float)));
+    EXPECT_TRUE(graph->Run());
+    EXPECT_TRUE(output_t->CopyDataFromTensor(output.data()));
+    EXPECT_EQ(output[0], 2.0f);
+    EXPECT_EQ(out[1][0], 1.0f) << "user buffer must not be written by the copy path";
+
+    EXPECT_FALSE(graph->Run({in1}, {out[0]}));
+}
+
+namespace {
+size_t CountCachedGraphs(const std::string& dir) {
+    size_t count = 0;
+    DIR* d = opendir(dir.c_str());
+    if (d) {
+        while (struct dirent* entry = readdir(d)) {
+            std::string name(entry->d_name);
+            if (name.size() > 4 && name.substr(name.size() - 4) == ".nbg") {
+                ++count;
+            }
+        }
+        closedir(d);
+    }
+    return count;
+}
+
+float RunCachedAdd(const std::shared_ptr<tim::vx::Context>& ctx,
+                   const tim::vx::CompileOption& option, float bias) {
+    auto graph = ctx->CreateGraph(option);
+
+    tim::vx::ShapeType io_shape({1,1,1,1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto bias_t = graph->CreateTensor(const_spec, &bias);
+    auto output_t = graph->CreateTensor(output_spec);
+
+    auto add = graph->CreateOperation<tim::vx::ops::Add>();
+    (*add).BindInputs({input_t, bias_t}).BindOutputs({output_t});
+
+    float in = 1.0f;
+    float output = 0.0f;
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(input_t->CopyDataToTensor(&in, sizeof(in)));
+    EXPECT_TRUE(graph->Run());
+    EXPECT_TRUE(output_t->CopyDataFromTensor(&output));
+    return output;
+}
+}  // namespace
+
+TEST(graph, compile_cache) {
+    char dir_template[] = "/tmp/tim_vx_cache_XXXXXX";
+    ASSERT_NE(mkdtemp(dir_template), nullptr);
+    std::string dir(dir_template);
+
+    auto ctx = tim::vx::Context::Create();
+    tim::vx::CompileOption option;
+    option.setCacheDir(dir);
+
+    // miss: compiled and stored
+    EXPECT_EQ(RunCachedAdd(ctx, option, 1.0f), 2.0f);
+    EXPECT_EQ(CountCachedGraphs(dir), 1u);
+
+    // hit: same structure and constants load the stored graph
+    EXPECT_EQ(RunCachedAdd(ctx, option, 1.0f), 2.0f);
+    EXPECT_EQ(CountCachedGraphs(dir), 1u);
+
+    // constant payload is part of the key
+    EXPECT_EQ(RunCachedAdd(ctx, option, 2.0f), 3.0f);
+    EXPECT_EQ(CountCachedGraphs(dir), 2u);
+
+    // a tiny limit keeps only the most recent graph
+    option.setCacheSizeLimit(1);
+    EXPECT_EQ(RunCachedAdd(ctx, option, 3.0f), 4.0f);
+    EXPECT_EQ(CountCachedGraphs(dir), 1u);
+
+    DIR* d = opendir(dir.c_str());
+    while (struct dirent* entry = readdir(d)) {
+        std::string name(entry->d_name);
+        if (name != "." && name != "..") {
+            unlink((dir + "/" + name).c_str());
+        }
+    }
+    closedir(d);
+    rmdir(dir.c_str());
+}
+
+namespace {
+std::shared_ptr<tim::vx::Graph> BuildFingerprintGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx, float alpha, float bias) {
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({2,2});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    std::vector<float> bias_data(4, bias);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto bias_t = graph->CreateTensor(const_spec, bias_data.data());
+    // the payload must not be read again once the tensor is created
+    std::fill(bias_data.begin(), bias_data.end(), 0.0f);
+    auto mid_t = graph->CreateTensor(transient_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+
+    graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({input_t, bias_t}).BindOutputs({mid_t});
+    graph->CreateOperation<tim::vx::ops::LeakyRelu>(alpha)->BindInputs({mid_t}).BindOutputs({output_t});
+    return graph;
+}
+}  // namespace
+
+TEST(graph, fingerprint) {
+    auto ctx = tim::vx::Context::Create();
+
+    auto base = BuildFingerprintGraph(ctx, 0.1f, 1.0f);
+    auto same = BuildFingerprintGraph(ctx, 0.1f, 1.0f);
+    auto other_param = BuildFingerprintGraph(ctx, 0.2f, 1.0f);
+    auto other_const = BuildFingerprintGraph(ctx, 0.1f, 2.0f);
+
+    EXPECT_EQ(base->Fingerprint(), same->Fingerprint());
+    EXPECT_EQ(base->Fingerprint(true), same->Fingerprint(true));
+
+    EXPECT_NE(base->Fingerprint(), other_param->Fingerprint());
+
+    // constant payloads only matter when asked for
+    EXPECT_EQ(base->Fingerprint(), other_const->Fingerprint());
+    EXPECT_NE(base->Fingerprint(true), other_const->Fingerprint(true));
+}
+
+namespace {
+std::shared_ptr<tim::vx::Graph> BuildTransposeGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx, std::vector<uint32_t> perm) {
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({2,2,2});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+
+    graph->CreateOperation<tim::vx::ops::Transpose>(perm)->BindInputs({input_t}).BindOutputs({output_t});
+    return graph;
+}
+}  // namespace
+
+TEST(graph, fingerprint_param_arrays) {
+    auto ctx = tim::vx::Context::Create();
+
+    // perm lives behind a pointer in nn_param, same shapes either way
+    auto base = BuildTransposeGraph(ctx, {1, 0, 2});
+    auto same = BuildTransposeGraph(ctx, {1, 0, 2});
+    auto other = BuildTransposeGraph(ctx, {0, 2, 1});
+
+    EXPECT_EQ(base->Fingerprint(), same->Fingerprint());
+    EXPECT_NE(base->Fingerprint(), other->Fingerprint());
+}
+
+TEST(graph, run_async_overlaps_host_work) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    // A long enough chain that the device is still busy when RunAsync returns
+    tim::vx::ShapeType io_shape({256, 256, 16});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    const int op_count = 16;
+    auto input_t = graph->CreateTensor(input_spec);
+    auto prev = input_t;
+    for (int i = 0; i < op_count; ++i) {
+        auto out = graph->CreateTensor(i + 1 == op_count ? output_spec : transient_spec);
+        graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({prev, input_t}).BindOutputs({out});
+        prev = out;
+    }
+    ASSERT_TRUE(graph->Compile());
+
+    const size_t count = input_spec.GetElementNum();
+    std::vector<float> input(count, 1.0f);
+    EXPECT_TRUE(input_t->CopyDataToTensor(input.data(), input.size() * sizeof(float)));
+
+    std::atomic<int> callbacks(0);
+    auto future = graph->RunAsync([&callbacks](bool status) {
+        EXPECT_TRUE(status);
+        ++callbacks;
+    });
+
+    // Host side work done while the graph executes
+    uint64_t host_iterations = 0;
+    volatile float sink = 0.0f;
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        for (size_t i = 0; i < 1024; ++i) {
+            sink = sink + input[i];
+        }
+        ++host_iterations;
+    }
+    EXPECT_TRUE(future.get());
+    EXPECT_GT(host_iterations, 0u) << "RunAsync must return before the graph finishes";
+    EXPECT_EQ(callbacks.load(), 1);
+
+    std::vector<float> output(count, 0.0f);
+    EXPECT_TRUE(prev->CopyDataFromTensor(output.data()));
+    EXPECT_EQ(output[0], static_cast<float>(op_count + 1));
+    EXPECT_EQ(output[count - 1], static_cast<float>(op_count + 1));
+}
+
+TEST(graph, run_async_in_flight_limit) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({16});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+    graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({input_t, input_t}).BindOutputs({output_t});
+    graph->SetMaxInFlight(2);
+
+    const int runs = 6;
+    alignas(64) float in[runs][16];
+    alignas(64) float out[runs][16];
+    std::vector<std::future<bool>> futures;
+    for (int r = 0; r < runs; ++r) {
+        for (int i = 0; i < 16; ++i) {
+            in[r][i] = static_cast<float>(r);
+        }
+        futures.push_back(graph->RunAsync({in[r]}, {out[r]}));
+    }
+    for (auto& f : futures) {
+        EXPECT_TRUE(f.get());
+    }
+    for (int r = 0; r < runs; ++r) {
+        EXPECT_EQ(out[r][0], 2.0f * r);
+        EXPECT_EQ(out[r][15], 2.0f * r);
+    }
+
+    // mismatched io is reported through the future
+    EXPECT_FALSE(graph->RunAsync({}, {}).get());
+}
+
+TEST(graph, run_async_callback_reentry) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({16});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+    graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({input_t, input_t}).BindOutputs({output_t});
+    graph->SetMaxInFlight(1);
+
+    // Both would wait for the callback itself, they fail instead
+    bool sync_status = true;
+    bool async_status = true;
+    auto raw = graph.get();
+    auto future = graph->RunAsync([raw, &sync_status, &async_status](bool status) {
+        EXPECT_TRUE(status);
+        sync_status = raw->Run();
+        async_status = raw->RunAsync().get();
+    });
+    EXPECT_TRUE(future.get());
+    EXPECT_FALSE(sync_status);
+    EXPECT_FALSE(async_status);
+
+    // The graph is still usable afterwards
+    EXPECT_TRUE(graph->Run());
+}
+
+TEST(graph, profiling) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({16});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto transient_t = graph->CreateTensor(transient_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+    auto add = graph->CreateOperation<tim::vx::ops::Add>();
+    auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+    add->BindInputs({input_t, input_t}).BindOutputs({transient_t});
+    relu->BindInputs({transient_t}).BindOutputs({output_t});
+
+    graph->EnableProfiling();
+    EXPECT_TRUE(graph->Compile());
+    const int runs = 3;
+    for (int r = 0; r < runs; ++r) {
+        EXPECT_TRUE(graph->Run());
+    }
+
+    auto profile = graph->GetProfile();
+    EXPECT_EQ(profile.runs.size(), runs);
+    ASSERT_EQ(profile.ops.size(), 2);
+    EXPECT_EQ(profile.ops[0].op, add);
+    EXPECT_EQ(profile.ops[1].op, relu);
+    for (const auto& op : profile.ops) {
+        EXPECT_FALSE(op.name.empty());
+        EXPECT_FALSE(op.kernel_type.empty());
+        EXPECT_EQ(op.samples.size(), runs);
+    }
+    EXPECT_EQ(profile.ops[0].input_bytes, 2 * 16 * sizeof(float));
+    EXPECT_EQ(profile.ops[0].output_bytes, 16 * sizeof(float));
+
+    auto json = profile.ToJson();
+    EXPECT_NE(json.find("\"kernel_type\""), std::string::npos);
+    auto trace = profile.ToChromeTrace();
+    EXPECT_EQ(trace.find("{\"traceEvents\""), 0);
+    EXPECT_NE(trace.find("\"ph\": \"X\""), std::string::npos);
+}
+
+TEST(graph, memory_report) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({16});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+    std::vector<std::shared_ptr<tim::vx::Tensor>> chain = {input_t};
+    for (int i = 0; i < 3; ++i) {
+        chain.push_back(graph->CreateTensor(transient_spec));
+    }
+    chain.push_back(output_t);
+    for (size_t i = 0; i + 1 < chain.size(); ++i) {
+        graph->CreateOperation<tim::vx::ops::Relu>()
+            ->BindInputs({chain[i]}).BindOutputs({chain[i + 1]});
+    }
+
+    EXPECT_TRUE(graph->GetMemoryReport().blocks.empty());
+    EXPECT_TRUE(graph->Compile());
+
+    // Each transient is live from its writer to its reader, only two
+    // neighbours overlap so the third reuses the first one's buffer
+    const uint64_t bytes = 16 * sizeof(float);
+    auto report = graph->GetMemoryReport();
+    ASSERT_EQ(report.blocks.size(), 3);
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(report.blocks[i].tensor_id, chain[i + 1]->GetId());
+        EXPECT_EQ(report.blocks[i].first, i);
+        EXPECT_EQ(report.blocks[i].last, i + 1);
+        EXPECT_EQ(report.blocks[i].size, bytes);
+    }
+    EXPECT_EQ(report.total_bytes, 3 * bytes);
+    EXPECT_EQ(report.peak_bytes, 2 * bytes);
+    EXPECT_EQ(report.arena_bytes, 2 * bytes);
+    EXPECT_EQ(report.blocks[0].offset, report.blocks[2].offset);
+    EXPECT_NE(report.blocks[0].offset, report.blocks[1].offset);
+}
+
+TEST(graph, inplace_elementwise_chain) {
+    // Options are read when the context is created
+    setenv("VSI_NN_ENABLE_INPLACE_OPTIMIZE", "1", 1);
+    auto ctx = tim::vx::Context::Create();
+    unsetenv("VSI_NN_ENABLE_INPLACE_OPTIMIZE");
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType io_shape({4});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, io_shape, tim::vx::TensorAttribute::OUTPUT);
+    auto input_t = graph->CreateTensor(input_spec);
+    auto sum_t = graph->CreateTensor(transient_spec);
+    auto relu_t = graph->CreateTensor(transient_spec);
+    auto output_t = graph->CreateTensor(output_spec);
+
+    // sum_t and relu_t are only read by the next op, both can be written over
+    graph->CreateOperation<tim::vx::ops::Add>()
+        ->BindInputs({input_t, input_t}).BindOutputs({sum_t});
+    graph->CreateOperation<tim::vx::ops::Relu>()
+        ->BindInputs({sum_t}).BindOutputs({relu_t});
+    graph->CreateOperation<tim::vx::ops::Multiply>()
+        ->BindInputs({relu_t, input_t}).BindOutputs({output_t});
+
+    std::vector<float> in = {-2.0f, -0.5f, 1.0f, 3.0f};
+    std::vector<float> golden = {0.0f, 0.0f, 2.0f, 18.0f};
+    EXPECT_TRUE(input_t->CopyDataToTensor(in.data(), in.size() * sizeof(float)));
+    EXPECT_TRUE(graph->Run());
+    std::vector<float> output(golden.size());
+    EXPECT_TRUE(output_t->CopyDataFromTensor(output.data()));
+    EXPECT_EQ(output, golden);
+
+    // Relu writes over sum_t, so relu_t has no buffer of its own and sum_t
+    // stays live until Multiply reads relu_t
+    auto report = graph->GetMemoryReport();
+    ASSERT_EQ(report.blocks.size(), 1);
+    EXPECT_EQ(report.blocks[0].tensor_id, sum_t->GetId());
+    EXPECT_EQ(report.blocks[0].first, 0);
+    EXPECT_EQ(report.blocks[0].last, 2);
+    EXPECT_EQ(report.total_bytes, 4 * sizeof(float));
+}
@@ -0,0 +1,151 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "hash_utils.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tim {
+namespace vx {
+
+namespace {
+
+constexpr uint64_t kC1 = 0x87c37b91114253d5ULL;
+constexpr uint64_t kC2 = 0x4cf5ad432745937fULL;
+
+inline uint64_t Rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t FMix(uint64_t k) {
+  k ^= k >> 33;
+  k *= 0xff51afd7ed558ccdULL;
+  k ^= k >> 33;
+  k *= 0xc4ceb9fe1a85ec53ULL;
+  k ^= k >> 33;
+  return k;
+}
+
+inline uint64_t Load64(const uint8_t* p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+}  // namespace
+
+Hasher128::Hasher128(uint64_t seed) : h1_(seed), h2_(seed) {}
+
+void Hasher128::Mix(uint64_t k1, uint64_t k2) {
+  k1 *= kC1;
+  k1 = Rotl(k1, 31);
+  k1 *= kC2;
+  h1_ ^= k1;
+  h1_ = Rotl(h1_, 27);
+  h1_ += h2_;
+  h1_ = h1_ * 5 + 0x52dce729;
+
+  k2 *= kC2;
+  k2 = Rotl(k2, 33);
+  k2 *= kC1;
+  h2_ ^= k2;
+  h2_ = Rotl(h2_, 31);
+  h2_ += h1_;
+  h2_ = h2_ * 5 + 0x38495ab5;
+}
+
+Hasher128& Hasher128::Update(const void* data, size_t size) {
+  const uint8_t* p = static_cast<const uint8_t*>(data);
+  length_ += size;
+
+  if (tail_size_ > 0) {
+    size_t n = std::min(size, sizeof(tail_) - tail_size_);
+    memcpy(tail_ + tail_size_, p, n);
+    tail_size_ += n;
+    p += n;
+    size -= n;
+    if (tail_size_ < sizeof(tail_)) {
+      return *this;
+    }
+    Mix(Load64(tail_), Load64(tail_ + 8));
+    tail_size_ = 0;
+  }
+
+  for (; size >= 16; p += 16, size -= 16) {
+    Mix(Load64(p), Load64(p + 8));
+  }
+
+  memcpy(tail_, p, size);
+  tail_size_ = size;
+  return *this;
+}
+
+Hasher128::Digest Hasher128::Final() const {
+  uint64_t h1 = h1_;
+  uint64_t h2 = h2_;
+  uint64_t k1 = 0;
+  uint64_t k2 = 0;
+
+  for (size_t i = tail_size_; i > 8; --i) {
+    k2 ^= static_cast<uint64_t>(tail_[i - 1]) << ((i - 9) * 8);
+  }
+  if (tail_size_ > 8) {
+    k2 *= kC2;
+    k2 = Rotl(k2, 33);
+    k2 *= kC1;
+    h2 ^= k2;
+  }
+  for (size_t i = std::min<size_t>(tail_size_, 8); i > 0; --i) {
+    k1 ^= static_cast<uint64_t>(tail_[i - 1]) << ((i - 1) * 8);
+  }
+  if (tail_size_ > 0) {
+    k1 *= kC1;
+    k1 = Rotl(k1, 31);
+    k1 *= kC2;
+    h1 ^= k1;
+  }
+
+  h1 ^= length_;
+  h2 ^= length_;
+  h1 += h2;
+  h2 += h1;
+  h1 = FMix(h1);
+  h2 = FMix(h2);
+  h1 += h2;
+  h2 += h1;
+  return {{h1, h2}};
+}
+
+std::string Hasher128::ToHex(const Digest& digest) {
+  static const char kHex[] = "0123456789abcdef";
+  std::string hex;
+  hex.reserve(32);
+  for (uint64_t word : digest) {
+    for (int shift = 60; shift >= 0; shift -= 4) {
+      hex.push_back(kHex[(word >> shift) & 0xf]);
+    }
+  }
+  return hex;
+}
+
+}  // namespace vx
+}  // namespace tim
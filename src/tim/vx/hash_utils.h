@@ -0,0 +1,75 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_HASH_UTILS_H_
+#define TIM_VX_HASH_UTILS_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace tim {
+namespace vx {
+
+/// Streaming 128-bit MurmurHash3 (x64 variant). Digests are stable across
+/// processes, so they can be used as on-disk keys.
+class Hasher128 {
+ public:
+  using Digest = std::array<uint64_t, 2>;
+
+  explicit Hasher128(uint64_t seed = 0);
+
+  Hasher128& Update(const void* data, size_t size);
+
+  template <typename T>
+  Hasher128& Update(const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only trivially copyable values can be hashed by bytes");
+    return Update(&value, sizeof(T));
+  }
+
+  Hasher128& Update(const std::string& str) {
+    Update(str.size());
+    return Update(str.data(), str.size());
+  }
+
+  Digest Final() const;
+
+  static std::string ToHex(const Digest& digest);
+
+ private:
+  void Mix(uint64_t k1, uint64_t k2);
+
+  uint64_t h1_;
+  uint64_t h2_;
+  uint8_t tail_[16];
+  size_t tail_size_{0};
+  uint64_t length_{0};
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_HASH_UTILS_H_ */
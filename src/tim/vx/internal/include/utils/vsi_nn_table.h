@@ -0,0 +1,89 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef _VSI_NN_TABLE_H
+#define _VSI_NN_TABLE_H
+
+#include <stdint.h>
+#include "vsi_nn_types.h"
+
+#if defined(__cplusplus)
+extern "C"{
+#endif
+
+/**
+ * Dense id-indexed table.
+ * Items are stored in a growable array addressed directly by their id,
+ * so lookups, insertions and removals are O(1). It is intended for keys
+ * that are allocated densely, such as graph tensor and node ids.
+ */
+typedef struct _vsi_nn_table
+{
+    /** Item slots, NULL if the slot is empty */
+    void    ** items;
+    /** Allocated slot number */
+    uint32_t   capacity;
+    /** Live item number */
+    uint32_t   size;
+} vsi_nn_table_t;
+
+OVXLIB_API void vsi_nn_TableInit
+    (
+    vsi_nn_table_t * table
+    );
+
+OVXLIB_API void vsi_nn_TableDeinit
+    (
+    vsi_nn_table_t * table
+    );
+
+OVXLIB_API void * vsi_nn_TableGet
+    (
+    const vsi_nn_table_t * table,
+    uint32_t               key
+    );
+
+OVXLIB_API vsi_bool vsi_nn_TableAdd
+    (
+    vsi_nn_table_t * table,
+    uint32_t         key,
+    void           * value
+    );
+
+OVXLIB_API void vsi_nn_TableRemove
+    (
+    vsi_nn_table_t * table,
+    uint32_t         key
+    );
+
+OVXLIB_API vsi_bool vsi_nn_TableHasKey
+    (
+    const vsi_nn_table_t * table,
+    uint32_t               key
+    );
+
+#if defined(__cplusplus)
+}
+#endif
+
+#endif
@@ -38,12 +38,36 @@ class Device;
 using func_t = std::function<bool (const void*)>;
 using data_t = const void*;
 
+/* Queued work is fetched from the highest priority level first, in
+   submission order within a level. */
+enum class Priority : uint32_t {
+    HIGH = 0,
+    NORMAL = 1,
+    LOW = 2,
+};
+constexpr uint32_t kPriorityLevels = 3;
+constexpr size_t kDefaultQueueCapacity = 128;
+constexpr uint32_t kDefaultWorkerCount = 2;
+
 class IDevice {
     public:
-        OVXLIB_API IDevice(uint32_t id);
+        /* worker_count threads run the queued graphs. cpu_mask restricts
+           them to the CPUs whose bit is set (bit i for CPU i), 0 keeps the
+           default affinity. */
+        OVXLIB_API IDevice(uint32_t id, size_t queue_capacity = kDefaultQueueCapacity,
+            uint32_t worker_count = kDefaultWorkerCount, uint64_t cpu_mask = 0);
         OVXLIB_API ~IDevice();
         OVXLIB_API uint32_t Id() const;
-        OVXLIB_API bool GraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data);
+        OVXLIB_API uint32_t WorkerCount() const;
+        /* Queue a graph (or, with a null graph, only func) for the worker
+           threads. Blocks while the queue is full, so do not call it from
+           func itself. */
+        OVXLIB_API bool GraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data,
+            Priority priority = Priority::NORMAL);
+        /* Same as GraphSubmit but returns false instead of blocking when
+           the queue is full. */
+        OVXLIB_API bool TryGraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data,
+            Priority priority = Priority::NORMAL);
         OVXLIB_API bool GraphRemove(const vsi_nn_graph_t* graph);
         OVXLIB_API bool ThreadExit();
         OVXLIB_API void WaitThreadIdle();
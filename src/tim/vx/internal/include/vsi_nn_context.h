@@ -77,6 +77,9 @@ typedef struct _vsi_nn_runtime_option_t
     int32_t enable_concat_optimize;
     int32_t enable_asymi8_to_u8;
     int32_t enable_dataconvert_optimize;
+    int32_t enable_dead_node_elimination;
+    int32_t enable_memory_schedule;
+    int32_t enable_inplace_optimize;
 } vsi_nn_runtime_option_t;
 
 /**
@@ -33,7 +33,7 @@
 #include "vsi_nn_ops.h"
 #include "vsi_nn_types.h"
 #include "vsi_nn_rnn.h"
-#include "utils/vsi_nn_map.h"
+#include "utils/vsi_nn_table.h"
 
 /**
  * Default max node input or output tensors' number.
@@ -71,6 +71,101 @@
 extern "C" {
 #endif
 
+/**
+ * Nodes bound to one tensor, sorted by node id.
+ */
+typedef struct _vsi_nn_tensor_link
+{
+    /** Node ids */
+    vsi_nn_node_id_t * nodes;
+    /** Number of io slots of each node bound to the tensor */
+    uint32_t         * refs;
+    /** Node number */
+    uint32_t           num;
+    /** Allocated node number */
+    uint32_t           capacity;
+} vsi_nn_tensor_link_t;
+
+/**
+ * Tensor adjacency
+ * Nodes reading and writing one tensor.
+ * @see vsi_nn_get_tensor_consumers
+ * @see vsi_nn_get_tensor_provider
+ */
+typedef struct _vsi_nn_tensor_adjacency
+{
+    /** Nodes read the tensor */
+    vsi_nn_tensor_link_t consumers;
+    /** Nodes write the tensor */
+    vsi_nn_tensor_link_t providers;
+} vsi_nn_tensor_adjacency_t;
+
+/**
+ * Swapped tensors
+ * Tensors whose handles were swapped since the graph was last run.
+ * @see vsi_nn_SwapTensorHandle
+ */
+typedef struct _vsi_nn_swapped_tensors
+{
+    /** Tensor ids */
+    vsi_nn_tensor_id_t * tensors;
+    /** Tensor number */
+    uint32_t             num;
+    /** Allocated tensor number */
+    uint32_t             capacity;
+} vsi_nn_swapped_tensors_t;
+
+/**
+ * Dead node elimination report
+ * @see vsi_nn_EliminateDeadNodes
+ */
+typedef struct _vsi_nn_elimination_report
+{
+    /** Removed node number */
+    uint32_t   removed_nodes;
+    /** Removed virtual and constant tensor number */
+    uint32_t   removed_tensors;
+    /** Bytes of the removed virtual tensors */
+    vsi_size_t saved_bytes;
+} vsi_nn_elimination_report_t;
+
+/**
+ * Buffer of a virtual tensor in a memory plan
+ * @see vsi_nn_PlanGraphMemory
+ */
+typedef struct _vsi_nn_memory_block
+{
+    /** Virtual tensor id */
+    vsi_nn_tensor_id_t tensor;
+    /** Execution position of the node writing the tensor */
+    uint32_t   first;
+    /** Execution position of the last node reading the tensor */
+    uint32_t   last;
+    /** Tensor bytes */
+    vsi_size_t size;
+    /** Offset of the buffer in the shared arena */
+    vsi_size_t offset;
+} vsi_nn_memory_block_t;
+
+/**
+ * Memory plan of the virtual tensors
+ * Blocks whose live ranges overlap never share bytes of the arena.
+ * @see vsi_nn_PlanGraphMemory
+ */
+typedef struct _vsi_nn_memory_plan
+{
+    /** Blocks in the order their tensors are first used */
+    vsi_nn_memory_block_t * blocks;
+    /** Block number */
+    uint32_t   block_num;
+    /** Bytes of all virtual tensors, what no reuse at all needs */
+    vsi_size_t total_bytes;
+    /** Most bytes live at once, no plan can do better */
+    vsi_size_t peak_bytes;
+    /** Arena bytes the plan needs */
+    vsi_size_t arena_bytes;
+} vsi_nn_memory_plan_t;
+
 /**
  * Graph structure
  */
@@ -86,7 +181,7 @@ struct _vsi_nn_graph
     /** @deprecated Never use tensors. */
     vsi_nn_tensor_t ** tensors;
     /** Tensor table */
-    vsi_nn_map_t     * tensor_table;
+    vsi_nn_table_t   * tensor_table;
     };
     union
     {
@@ -103,7 +198,7 @@ struct _vsi_nn_graph
     /** @deprecated: Never use nodes. */
     vsi_nn_node_t   ** nodes;
     /** Node table */
-    vsi_nn_map_t     * node_table;
+    vsi_nn_table_t   * node_table;
     };
     union
     {
@@ -167,6 +262,59 @@ struct _vsi_nn_graph
     } complete_signal;
 
     vsi_bool isAllowFastMode;
+
+    /**
+     * Tensor adjacency indexed by tensor id, it is maintained by
+     * vsi_nn_AddNode(), vsi_nn_RemoveNode() and the node io setters.
+     * @see vsi_nn_SetNodeInput
+     * @see vsi_nn_SetNodeOutput
+     */
+    struct
+    {
+        vsi_nn_tensor_adjacency_t * tensors;
+        uint32_t                    capacity;
+    } adjacency;
+
+    /**
+     * Tensors to rebind on the next run, appended by
+     * vsi_nn_SwapTensorHandle(). It is allocated separately so that
+     * vsi_nn_RunGraph() can drain it through a const graph.
+     */
+    vsi_nn_swapped_tensors_t * swapped;
+
+    /**
+     * Node being instanced by vsi_nn_SetupGraph(), the kernel selector
+     * records the kernel type it picks on it.
+     * @see vsi_nn_node_t::kernel_types
+     */
+    vsi_nn_node_t * compute_node;
+
+    /**
+     * What vsi_nn_SetupGraph() removed when dead node elimination is
+     * enabled by VSI_NN_ENABLE_DEAD_NODE_ELIMINATION.
+     */
+    vsi_nn_elimination_report_t elimination;
+
+    /**
+     * Tensor each virtual tensor was made a view of by
+     * vsi_nn_InplaceOptimizeGraph(), VSI_NN_TENSOR_ID_NA when it owns
+     * its buffer.
+     */
+    vsi_nn_tensor_id_t * inplace_source;
+    uint32_t inplace_source_num;
+
+    /**
+     * Memory plan of the execution order vsi_nn_SetupGraph() picked, only
+     * built by vsi_nn_GetGraphMemoryPlan().
+     */
+    vsi_nn_memory_plan_t memory_plan;
+
+    /**
+     * Execution order vsi_nn_SetupGraph() picked, kept until
+     * vsi_nn_GetGraphMemoryPlan() plans it.
+     */
+    vsi_nn_node_id_t * exec_order;
+    uint32_t exec_order_num;
 };
 
 /**
@@ -707,6 +855,164 @@ vsi_status vsi_nn_setup_binary_graph_inputs_outputs
     vsi_nn_graph_t* graph
     );
 
+/**
+ * Set node input
+ * Bind a tensor to the node input and update the graph tensor adjacency.
+ *
+ * @param[in] node Node handle.
+ * @param[in] index Input index.
+ * @param[in] id Tensor id, VSI_NN_TENSOR_ID_NA to unbind.
+ *
+ * @return VSI_SUCCESS on success, or error core otherwise.
+ */
+OVXLIB_API vsi_status vsi_nn_SetNodeInput
+    (
+    vsi_nn_node_t      * node,
+    uint32_t             index,
+    vsi_nn_tensor_id_t   id
+    );
+
+/**
+ * Set node output
+ * Bind a tensor to the node output and update the graph tensor adjacency.
+ *
+ * @param[in] node Node handle.
+ * @param[in] index Output index.
+ * @param[in] id Tensor id, VSI_NN_TENSOR_ID_NA to unbind.
+ *
+ * @return VSI_SUCCESS on success, or error core otherwise.
+ */
+OVXLIB_API vsi_status vsi_nn_SetNodeOutput
+    (
+    vsi_nn_node_t      * node,
+    uint32_t             index,
+    vsi_nn_tensor_id_t   id
+    );
+
+/**
+ * Refresh tensor adjacency
+ * Rebuild the graph tensor adjacency from the node io, this is only
+ * required if node io tensors are written directly instead of
+ * through vsi_nn_SetNodeInput() and vsi_nn_SetNodeOutput().
+ *
+ * @param[in] graph Graph handle.
+ *
+ * @return VSI_SUCCESS on success, or error core otherwise.
+ */
+OVXLIB_API vsi_status vsi_nn_RefreshTensorAdjacency
+    (
+    vsi_nn_graph_t * graph
+    );
+
+/**
+ * Eliminate dead nodes
+ * Remove the nodes none of whose outputs reach a graph output or a
+ * non-virtual tensor, then the virtual and constant tensors only they
+ * used. Node ids are compacted afterwards. It must run before the graph
+ * is set up, vsi_nn_SetupGraph() runs it when the context option
+ * enable_dead_node_elimination is set.
+ *
+ * @param[in] graph Graph handle, its outputs must be set.
+ * @param[out] report What was removed, it can be NULL.
+ *
+ * @return VSI_SUCCESS on success, or error core otherwise.
+ */
+OVXLIB_API vsi_status vsi_nn_EliminateDeadNodes
+    (
+    vsi_nn_graph_t * graph,
+    vsi_nn_elimination_report_t * report
+    );
+
+/**
+ * Plan graph memory
+ * Compute the live range of each virtual tensor over the node order, from
+ * the node writing it to the last node reading it, and pack the buffers
+ * into one arena by interval coloring: the largest buffers are placed
+ * first, each at the lowest offset not used by a buffer live at the same
+ * time. A tensor written in place over its input extends the input's
+ * block instead of getting one. Tensor shapes must be known, so the graph
+ * must be set up.
+ *
+ * @param[in] graph Graph handle.
+ * @param[in] nodes Node execution order, NULL to use vsi_nn_SortGraphNode().
+ * @param[in] node_num Node number of the order.
+ * @param[out] plan Memory plan, release it with vsi_nn_ReleaseMemoryPlan().
+ *
+ * @return VSI_SUCCESS on success, or error core otherwise.
+ */
+OVXLIB_API vsi_status vsi_nn_PlanGraphMemory
+    (
+    vsi_nn_graph_t * graph,
+    const vsi_nn_node_id_t * nodes,
+    uint32_t node_num,
+    vsi_nn_memory_plan_t * plan
+    );
+
+/**
+ * Release memory plan
+ * Free the blocks of a plan and reset it.
+ *
+ * @param[in] plan Memory plan.
+ */
+OVXLIB_API void vsi_nn_ReleaseMemoryPlan
+    (
+    vsi_nn_memory_plan_t * plan
+    );
+
+/**
+ * Get graph memory plan
+ * Plan the execution order of the last vsi_nn_SetupGraph() on the first
+ * call and keep the plan on the graph, so setup never pays for a plan no
+ * one reads.
+ *
+ * @param[in] graph Graph handle.
+ *
+ * @return The plan owned by the graph, empty before setup, or NULL when
+ *         planning failed.
+ */
+OVXLIB_API const vsi_nn_memory_plan_t * vsi_nn_GetGraphMemoryPlan
+    (
+    vsi_nn_graph_t * graph
+    );
+
+/**
+ * Schedule graph memory
+ * Reorder a topological node order so that fewer virtual tensor bytes are
+ * live at once. Among the nodes whose inputs are ready, the one adding the
+ * fewest bytes, outputs written minus inputs read for the last time, runs
+ * first, ties keep the given order. The order is only replaced when its
+ * peak is lower. vsi_nn_SetupGraph() runs it when the context option
+ * enable_memory_schedule is set.
+ *
+ * @param[in] graph Graph handle, it must be set up.
+ * @param[in,out] nodes Node execution order.
+ * @param[in] node_num Node number of the order.
+ *
+ * @return VSI_SUCCESS on success, or error core otherwise.
+ */
+OVXLIB_API vsi_status vsi_nn_ScheduleGraphMemory
+    (
+    vsi_nn_graph_t * graph,
+    vsi_nn_node_id_t * nodes,
+    uint32_t node_num
+    );
+
+/**
+ * Mark tensor swapped
+ * Queue a swapped tensor of the graph so that the next run rebinds it
+ * to the nodes which need it, it is called by vsi_nn_SwapTensorHandle().
+ *
+ * @param[in] graph Graph handle.
+ * @param[in] id Tensor id.
+ *
+ * @return VSI_SUCCESS on success, or error core otherwise.
+ */
+vsi_status vsi_nn_MarkTensorSwapped
+    (
+    vsi_nn_graph_t     * graph,
+    vsi_nn_tensor_id_t   id
+    );
+
 void  vsi_nn_get_tensor_consumers
     (
     vsi_nn_graph_t* graph,
@@ -45,6 +45,26 @@ vsi_status vsi_nn_OptimizeGraph
     vsi_bool *dirty
     );
 
+/**
+ * Inplace optimize graph
+ * Let elementwise and activation nodes write their output over an input
+ * which only they read. The input must be a virtual tensor of the same
+ * shape and dtype as the output, the output is created as a view of it.
+ * It runs on set up graphs before the vx nodes are created,
+ * vsi_nn_SetupGraph() runs it when the context option
+ * enable_inplace_optimize is set.
+ *
+ * @param[in] graph Graph handle.
+ * @param[in] node_list Node execution order.
+ *
+ * @return VSI_SUCCESS on success, or error core otherwise.
+ */
+vsi_status vsi_nn_InplaceOptimizeGraph
+    (
+    vsi_nn_graph_t* graph,
+    const vsi_nn_node_id_t* node_list
+    );
+
 #ifdef __cplusplus
 }
 #endif
@@ -96,6 +96,14 @@ struct _vsi_nn_node
     /** Node's internal node wksp */
     void* internal_node_wksp;
     vsi_nn_node_attr_t attr;
+    /** Node id in graph, VSI_NN_NODE_ID_NA if not added to graph */
+    vsi_nn_node_id_t id;
+    /**
+     * Kernel types instanced for the node, one bit per
+     * vsi_nn_kernel_type_e, including those of its internal nodes.
+     * It is filled by vsi_nn_SetupGraph().
+     */
+    uint32_t kernel_types;
 };
 
 /*------------------------------------
@@ -184,6 +192,24 @@ vsi_status vsi_nn_SetNodeInputsAndOutputs
     int output_num
     );
 
+/**
+ * Get node performance
+ * Query the device time of the node's last run. For nodes expanded into
+ * internal nodes, the time is summed over them and the range spans all
+ * of them. Performance must be enabled on the context with
+ * VX_DIRECTIVE_ENABLE_PERFORMANCE before the graph is verified.
+ *
+ * @param[in] node Node handle.
+ * @param[out] perf Performance of the last run, tmp, beg and end are set.
+ *
+ * @return VSI_SUCCESS on success, or appropriate error code otherwise
+ */
+OVXLIB_API vsi_status vsi_nn_GetNodePerf
+    (
+    vsi_nn_node_t * node,
+    vx_perf_t * perf
+    );
+
 #if defined(__cplusplus)
 }
 #endif
@@ -168,6 +168,10 @@ struct _vsi_nn_tensor
     vx_weights_biases_parameter wb;
     /** Mark tensor swapped by vxSwapTensor */
     int8_t  is_swapped;
+    /** Graph the tensor is attached to, NULL if it is not attached */
+    vsi_nn_graph_t * graph;
+    /** Tensor id in the attached graph */
+    vsi_nn_tensor_id_t id;
 };
 
 /**
@@ -1263,6 +1263,10 @@ vsi_nn_kernel_node_t vsi_nn_kernel_selector
             {
                 VSILOGD("Instance %s node with kernel \"%s\" ",
                     vsi_nn_kernel_type_str(type), kernel_name);
+                if( graph->compute_node )
+                {
+                    graph->compute_node->kernel_types |= 1 << type;
+                }
                 break;
             }
         }
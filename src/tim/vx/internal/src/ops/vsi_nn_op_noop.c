@@ -75,6 +75,7 @@ static vsi_bool op_setup
     )
 {
     int i;
+    vsi_nn_tensor_id_t id;
     for( i = 0; i < 10; i ++ )
     {
         if( NULL == outputs[i] )
@@ -95,13 +96,18 @@ static vsi_bool op_setup
             {
                 if( NULL == inputs[0]->t )
                 {
+                    /* Keep the graph slot of the overwritten tensor */
+                    id = inputs[0]->id;
                     memcpy( inputs[0], outputs[i], sizeof( vsi_nn_tensor_t ) );
+                    inputs[0]->id = id;
                 }
                 else
                 {
                     VSILOGE( "Invalid NOOP tensors." );
                     vxReleaseTensor( &outputs[i]->t );
+                    id = outputs[i]->id;
                     memcpy( outputs[i], inputs[0], sizeof( vsi_nn_tensor_t ) );
+                    outputs[i]->id = id;
                 }
             }
         }
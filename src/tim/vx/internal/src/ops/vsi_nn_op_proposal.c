@@ -234,8 +234,8 @@ static vsi_bool op_setup
         im_info = create_im_info_tensor( node->graph,
             &node->nn_param.proposal.im_info );
         inputs[2] = im_info;
-        node->input.tensors[2] = vsi_nn_AttachTensorToGraph(
-            node->graph, VSI_NN_TENSOR_ID_AUTO, im_info );
+        vsi_nn_SetNodeInput( node, 2, vsi_nn_AttachTensorToGraph(
+            node->graph, VSI_NN_TENSOR_ID_AUTO, im_info ) );
     }
 
     /* Check and generate anchors */
@@ -244,8 +244,8 @@ static vsi_bool op_setup
         anchors = create_anchor_tensor( node->graph,
             &node->nn_param.proposal.anchor );
         inputs[3] = anchors;
-        node->input.tensors[3] = vsi_nn_AttachTensorToGraph(
-            node->graph, VSI_NN_TENSOR_ID_AUTO, anchors );
+        vsi_nn_SetNodeInput( node, 3, vsi_nn_AttachTensorToGraph(
+            node->graph, VSI_NN_TENSOR_ID_AUTO, anchors ) );
     }
 
     if( VSI_NN_DIM_AUTO == outputs[0]->attr.dim_num )
@@ -0,0 +1,151 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#include <string.h>
+#include <stdlib.h>
+#include "utils/vsi_nn_table.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_types.h"
+
+#define _TABLE_MIN_CAPACITY    (64)
+
+static vsi_bool _reserve
+    (
+    vsi_nn_table_t * table,
+    uint32_t         key
+    )
+{
+    uint32_t capacity;
+    void ** items;
+
+    if( key < table->capacity )
+    {
+        return TRUE;
+    }
+    capacity = table->capacity > 0 ? table->capacity : _TABLE_MIN_CAPACITY;
+    while( capacity <= key )
+    {
+        if( capacity > UINT32_MAX / 2 )
+        {
+            capacity = UINT32_MAX;
+            break;
+        }
+        capacity *= 2;
+    }
+    items = (void **)realloc( table->items, sizeof( void * ) * capacity );
+    if( NULL == items )
+    {
+        VSILOGE( "Grow table to %u items fail.", capacity );
+        return FALSE;
+    }
+    memset( &items[table->capacity], 0,
+        sizeof( void * ) * ( capacity - table->capacity ) );
+    table->items = items;
+    table->capacity = capacity;
+    return TRUE;
+} /* _reserve() */
+
+void vsi_nn_TableInit
+    (
+    vsi_nn_table_t * table
+    )
+{
+    if( NULL == table )
+    {
+        return;
+    }
+    memset( table, 0, sizeof( vsi_nn_table_t ) );
+} /* vsi_nn_TableInit() */
+
+void vsi_nn_TableDeinit
+    (
+    vsi_nn_table_t * table
+    )
+{
+    if( NULL == table )
+    {
+        return;
+    }
+    free( table->items );
+    memset( table, 0, sizeof( vsi_nn_table_t ) );
+} /* vsi_nn_TableDeinit() */
+
+void * vsi_nn_TableGet
+    (
+    const vsi_nn_table_t * table,
+    uint32_t               key
+    )
+{
+    if( NULL == table || key >= table->capacity )
+    {
+        return NULL;
+    }
+    return table->items[key];
+} /* vsi_nn_TableGet() */
+
+vsi_bool vsi_nn_TableAdd
+    (
+    vsi_nn_table_t * table,
+    uint32_t         key,
+    void           * value
+    )
+{
+    if( NULL == table || NULL == value || FALSE == _reserve( table, key ) )
+    {
+        return FALSE;
+    }
+    if( NULL == table->items[key] )
+    {
+        table->size += 1;
+    }
+    table->items[key] = value;
+    return TRUE;
+} /* vsi_nn_TableAdd() */
+
+void vsi_nn_TableRemove
+    (
+    vsi_nn_table_t * table,
+    uint32_t         key
+    )
+{
+    if( NULL == table || key >= table->capacity )
+    {
+        return;
+    }
+    if( NULL != table->items[key] )
+    {
+        table->items[key] = NULL;
+        table->size -= 1;
+    }
+} /* vsi_nn_TableRemove() */
+
+vsi_bool vsi_nn_TableHasKey
+    (
+    const vsi_nn_table_t * table,
+    uint32_t               key
+    )
+{
+    return NULL != vsi_nn_TableGet( table, key );
+} /* vsi_nn_TableHasKey() */
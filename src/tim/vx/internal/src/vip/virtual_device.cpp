@@ -27,9 +27,14 @@
 
 namespace vip {
 
-Device::Device(uint32_t id) {
+Device::Device(uint32_t id, size_t queue_capacity, uint32_t worker_count,
+    uint64_t cpu_mask) {
     id_ = id;
-    graphqueue_ = std::make_unique<GraphQueue> ();
+    cpu_mask_ = cpu_mask;
+    threads_.resize(worker_count > 0 ? worker_count : 1);
+    submitted_ = 0;
+    completed_ = 0;
+    graphqueue_ = std::make_unique<GraphQueue> (queue_capacity);
     worker_ = std::make_unique<Worker> ();;
     ThreadInit();
 }
@@ -42,16 +47,47 @@ uint32_t Device::Id() const{
     return id_;
 }
 
+uint32_t Device::WorkerCount() const{
+    return static_cast<uint32_t>(threads_.size());
+}
+
 void Device::ThreadInit() {
     for (std::size_t i = 0; i < threads_.size(); ++i) {
         std::thread t(&Device::HandleQueue, this);
+        SetAffinity(t);
         threads_[i] = std::move(t);
     }
 }
 
+void Device::SetAffinity(std::thread& thread) {
+    if (0 == cpu_mask_) {
+        return;
+    }
+#if defined(__linux__)
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (uint32_t cpu = 0; cpu < 64 && cpu < CPU_SETSIZE; cpu++) {
+        if (cpu_mask_ & (uint64_t(1) << cpu)) {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    int ret = pthread_setaffinity_np(thread.native_handle(), sizeof(cpus), &cpus);
+    if (0 != ret) {
+        VSILOGW("Set affinity 0x%llx of device%u worker fail(%d)",
+            (unsigned long long)cpu_mask_, id_, ret);
+    }
+#else
+    (void)thread;
+    VSILOGW("Worker affinity is not supported on this platform");
+#endif
+}
+
 bool Device::ThreadExit() {
     for (std::size_t i = 0; i < threads_.size(); ++i) {
-        graphqueue_->Submit(nullptr, NULL, NULL);  // submit fake graph to exit thread
+        if (threads_[i].joinable()) {
+            // submit fake graph to exit thread, after all queued work
+            graphqueue_->Submit(nullptr, NULL, NULL, Priority::LOW);
+        }
     }
     for (std::size_t i = 0; i < threads_.size(); ++i) {
         if (threads_[i].joinable()) {
@@ -61,19 +97,45 @@ bool Device::ThreadExit() {
     return true;
 }
 
-bool Device::GraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data) {
+bool Device::GraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data,
+    Priority priority, bool block) {
     bool status = false;
-    status = graphqueue_->Submit(graph, func, data);
+    bool is_work = (nullptr != graph || NULL != func);
+    if (is_work) {
+        std::lock_guard<std::mutex> lock(idle_mtx_);
+        submitted_++;
+    }
+    status = graphqueue_->Submit(graph, func, data, priority, block);
+    if (!status && is_work) {
+        MarkCompleted();  // rejected work never runs
+    }
     return status;
 }
 
 bool Device::GraphRemove(const vsi_nn_graph_t* graph) {
-    return graphqueue_->Remove(graph);
+    bool removed = graphqueue_->Remove(graph);
+    if (removed) {
+        MarkCompleted();
+    }
+    return removed;
+}
+
+void Device::MarkCompleted() {
+    {
+        std::lock_guard<std::mutex> lock(idle_mtx_);
+        completed_++;
+    }
+    idle_cv_.notify_all();
+}
+
+bool Device::ThreadIdle() {
+    std::lock_guard<std::mutex> lock(idle_mtx_);
+    return completed_ == submitted_;
 }
 
 void Device::WaitThreadIdle() {
-    ThreadExit();
-    ThreadInit();
+    std::unique_lock<std::mutex> lock(idle_mtx_);
+    idle_cv_.wait(lock, [this]() { return completed_ == submitted_; });
 }
 
 Worker::Worker() {
@@ -108,19 +170,36 @@ void Device::HandleQueue() {
             break;
         }
         worker_->Handle(item);  // run graph
+        MarkCompleted();
     }
 }
 
-GraphQueue::GraphQueue() {
+GraphQueue::GraphQueue(size_t capacity) {
     gcount_ = 1;  // 0 for fake graph
+    capacity_ = capacity > 0 ? capacity : 1;
+    used_ = 0;
+    size_ = 0;
+    for (auto& ring : rings_) {
+        ring.slots.resize(capacity_);
+        ring.head = 0;
+        ring.count = 0;
+        for (auto& slot : ring.slots) {
+            slot.valid = false;
+        }
+    }
 }
 
 void GraphQueue::Show() {
     queue_mtx_.lock();
     VSILOGI("Queue element:");
-    for (std::size_t i=0; i < queue_.size(); i++) {
-        auto gid = queue_[i].id;
-        VSILOGI("%d", gid);
+    for (uint32_t level = 0; level < kPriorityLevels; level++) {
+        const Ring& ring = rings_[level];
+        for (std::size_t i = 0; i < ring.count; i++) {
+            const QueueItem& slot = ring.slots[(ring.head + i) % capacity_];
+            if (slot.valid) {
+                VSILOGI("%d (priority %u)", slot.id, level);
+            }
+        }
     }
     queue_mtx_.unlock();
 }
@@ -129,84 +208,174 @@ void GraphQueue::Notify() {
     cv_.notify_one();
 }
 
-bool GraphQueue::Submit(vsi_nn_graph_t* graph, func_t func, data_t data) {
-    queue_mtx_.lock();
-    QueueItem item;
-    item.graph = graph;
-    item.func = func;
-    item.data = data;
-    if (nullptr != graph) {
-        item.id = gcount_;
-        VSILOGI("Submit graph%ld", item.id);
-        gcount_++;
-        if (size_t(-1) == gcount_) {
-            gcount_ = 1;
+size_t GraphQueue::SlotKey(uint32_t level, size_t slot) const {
+    return level * capacity_ + slot;
+}
+
+size_t GraphQueue::TrimRing(uint32_t level) {
+    Ring& ring = rings_[level];
+    size_t freed = 0;
+    while (ring.count > 0 && !ring.slots[ring.head].valid) {
+        ring.head = (ring.head + 1) % capacity_;
+        ring.count--;
+        freed++;
+    }
+    while (ring.count > 0 &&
+        !ring.slots[(ring.head + ring.count - 1) % capacity_].valid) {
+        ring.count--;
+        freed++;
+    }
+    used_ -= freed;
+    return freed;
+}
+
+void GraphQueue::ForgetPending(const vsi_nn_graph_t* graph, size_t key) {
+    auto it = pending_.find(graph);
+    if (it == pending_.end()) {
+        return;
+    }
+    // Only holds the queued submissions of one graph, usually a single one
+    auto& keys = it->second;
+    for (auto k = keys.begin(); k != keys.end(); ++k) {
+        if (*k == key) {
+            keys.erase(k);
+            break;
         }
     }
-    else{
-        item.id = 0;  // fake graph
+    if (keys.empty()) {
+        pending_.erase(it);
+    }
+}
+
+bool GraphQueue::Submit(vsi_nn_graph_t* graph, func_t func, data_t data,
+    Priority priority, bool block) {
+    uint32_t level = static_cast<uint32_t>(priority);
+    if (level >= kPriorityLevels) {
+        level = kPriorityLevels - 1;
+    }
+    size_t id = 0;  // fake graph
+    {
+        std::unique_lock<std::mutex> lock(queue_mtx_);
+        if (used_ >= capacity_) {
+            if (!block) {
+                return false;
+            }
+            not_full_cv_.wait(lock, [this]() { return used_ < capacity_; });
+        }
+        if (nullptr != graph || NULL != func) {
+            id = gcount_;
+            gcount_++;
+            if (size_t(-1) == gcount_) {
+                gcount_ = 1;
+            }
+        }
+        Ring& ring = rings_[level];
+        size_t slot = (ring.head + ring.count) % capacity_;
+        QueueItem& item = ring.slots[slot];
+        item.id = id;
+        item.graph = graph;
+        item.func = func;
+        item.data = data;
+        item.valid = true;
+        ring.count++;
+        used_++;
+        size_++;
+        if (nullptr != graph) {
+            pending_[graph].push_back(SlotKey(level, slot));
+        }
+    }
+    if (0 != id) {
+        VSILOGI("Submit graph%ld", id);
     }
-    queue_.push_back(item);
-    queue_mtx_.unlock();
     Notify();
     return true;
 }
 
 QueueItem GraphQueue::Fetch() {
+    QueueItem item = {(size_t)-1, nullptr, NULL, NULL, false};
+    size_t freed = 0;
+    {
         std::unique_lock<std::mutex> lock(queue_mtx_);
-        QueueItem item = {(size_t)-1, nullptr, NULL, NULL};
-        if (queue_.empty()) {
-            cv_.wait(lock);
-        }
-        if (!queue_.empty()) {
-            auto first = queue_[0];
-            item.id = first.id;
-            item.graph = first.graph;
-            item.func = first.func;
-            item.data = first.data;
-            queue_.erase(queue_.begin());
+        cv_.wait(lock, [this]() { return size_ > 0; });
+        for (uint32_t level = 0; level < kPriorityLevels && !item.valid; level++) {
+            Ring& ring = rings_[level];
+            while (ring.count > 0) {
+                size_t slot = ring.head;
+                QueueItem& first = ring.slots[slot];
+                ring.head = (ring.head + 1) % capacity_;
+                ring.count--;
+                used_--;
+                freed++;
+                if (!first.valid) {
+                    continue;  // removed
+                }
+                item = std::move(first);
+                first.valid = false;
+                first.func = NULL;
+                size_--;
+                if (nullptr != item.graph) {
+                    ForgetPending(item.graph, SlotKey(level, slot));
+                }
+                break;
+            }
         }
-        // VSILOGD("Fetch graph%ld[%p] in thread[%ld]", item.id, item.graph, std::this_thread::get_id());
-        return item;
+    }
+    if (freed > 1) {
+        not_full_cv_.notify_all();
+    } else {
+        not_full_cv_.notify_one();
+    }
+    // VSILOGD("Fetch graph%ld[%p] in thread[%ld]", item.id, item.graph, std::this_thread::get_id());
+    return item;
 }
 
 bool GraphQueue::Remove(const vsi_nn_graph_t* graph) {
-    queue_mtx_.lock();
-    std::size_t idx=0;
-    bool exist=false;
-    if (!queue_.empty()) {
-        for (std::size_t i=0; i < queue_.size(); i++) {
-            if (graph == queue_[i].graph) {
-                idx = i;
-                exist = true;
-            }
+    size_t gid = 0;
+    size_t freed = 0;
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx_);
+        auto it = pending_.find(graph);
+        if (it == pending_.end()) {
+            return false;
         }
-        if (exist) {
-            auto gid = queue_[idx].id;
-            queue_.erase(queue_.begin() + idx);
-            VSILOGI("Remove graph%ld", gid);
+        // Remove the latest submission of the graph
+        size_t key = it->second.back();
+        it->second.pop_back();
+        if (it->second.empty()) {
+            pending_.erase(it);
         }
+        uint32_t level = static_cast<uint32_t>(key / capacity_);
+        QueueItem& slot = rings_[level].slots[key % capacity_];
+        gid = slot.id;
+        slot.valid = false;
+        slot.func = NULL;
+        size_--;
+        freed = TrimRing(level);
     }
-    queue_mtx_.unlock();
+    if (freed > 0) {
+        not_full_cv_.notify_all();
+    }
+    VSILOGI("Remove graph%ld", gid);
     return true;
 }
 
 bool GraphQueue::Empty() {
-        queue_mtx_.lock();
-        bool status = queue_.empty();
-        queue_mtx_.unlock();
-    return status;
+    std::lock_guard<std::mutex> lock(queue_mtx_);
+    return 0 == size_;
 }
 
 size_t GraphQueue::Size() {
-        queue_mtx_.lock();
-        size_t size = queue_.size();
-        queue_mtx_.unlock();
-    return size;
+    std::lock_guard<std::mutex> lock(queue_mtx_);
+    return size_;
+}
+
+size_t GraphQueue::Capacity() const {
+    return capacity_;
 }
 
-IDevice::IDevice(uint32_t id) {
-    device_ = new Device(id);
+IDevice::IDevice(uint32_t id, size_t queue_capacity, uint32_t worker_count,
+    uint64_t cpu_mask) {
+    device_ = new Device(id, queue_capacity, worker_count, cpu_mask);
 }
 
 IDevice::~IDevice() {
@@ -217,8 +386,18 @@ uint32_t IDevice::Id() const{
     return device_->Id();
 }
 
-bool IDevice::GraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data) {
-    return device_->GraphSubmit(graph, func, data);
+uint32_t IDevice::WorkerCount() const{
+    return device_->WorkerCount();
+}
+
+bool IDevice::GraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data,
+    Priority priority) {
+    return device_->GraphSubmit(graph, func, data, priority, true);
+}
+
+bool IDevice::TryGraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data,
+    Priority priority) {
+    return device_->GraphSubmit(graph, func, data, priority, false);
 }
 
 bool IDevice::GraphRemove(const vsi_nn_graph_t* graph) {
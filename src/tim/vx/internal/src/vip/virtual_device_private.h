@@ -35,38 +35,66 @@
 #include <unistd.h>
 #include <condition_variable>
 #include <functional>
+#include <unordered_map>
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 extern "C" {
     #include "vsi_nn_pub.h"
 };
 
+#include "vip/virtual_device.h"
+
 namespace vip {
 
-using func_t = std::function<bool (const void*)>;
-using data_t = const void*;
 typedef struct _Queueitem{
     size_t id;
     vsi_nn_graph_t* graph;
     func_t func;
     data_t data;
+    bool valid;  /* false for an empty or removed slot */
 } QueueItem;
 
+/* Bounded multi-producer/multi-consumer queue with one ring per priority
+   level. Every operation is O(1) under the lock: Remove() looks the graph
+   up in pending_ and leaves a tombstone which Fetch() skips. Tombstones
+   keep their slot until trimmed from either end of a ring or fetched. */
 class GraphQueue{
     public:
-        GraphQueue();
+        GraphQueue(size_t capacity = kDefaultQueueCapacity);
         ~GraphQueue(){};
         void Show();
-        bool Submit(vsi_nn_graph_t* graph, func_t func, data_t data);
+        bool Submit(vsi_nn_graph_t* graph, func_t func, data_t data,
+            Priority priority = Priority::NORMAL, bool block = true);
         bool Remove(const vsi_nn_graph_t* graph);
         QueueItem Fetch();
         bool Empty();
         size_t Size();
+        size_t Capacity() const;
         void Notify();
 
     protected:
-        std::vector<QueueItem> queue_;
+        struct Ring {
+            std::vector<QueueItem> slots;
+            size_t head;
+            size_t count;  /* occupied slots, tombstones included */
+        };
+
+        size_t SlotKey(uint32_t level, size_t slot) const;
+        size_t TrimRing(uint32_t level);
+        void ForgetPending(const vsi_nn_graph_t* graph, size_t key);
+
+        std::array<Ring, kPriorityLevels> rings_;
+        /* Slot keys of the queued submissions of each graph, newest last */
+        std::unordered_map<const vsi_nn_graph_t*, std::vector<size_t>> pending_;
+        size_t capacity_;
+        size_t used_;   /* occupied slots over all rings */
+        size_t size_;   /* queued items which are not removed */
         std::mutex queue_mtx_;
         std::condition_variable cv_;
+        std::condition_variable not_full_cv_;
         size_t gcount_;
 };
 
@@ -81,24 +109,37 @@ class Worker{
 
 class Device {
     public:
-        Device(uint32_t id);
+        Device(uint32_t id, size_t queue_capacity = kDefaultQueueCapacity,
+            uint32_t worker_count = kDefaultWorkerCount, uint64_t cpu_mask = 0);
         ~Device();
         uint32_t Id() const;
+        uint32_t WorkerCount() const;
         void ThreadInit();
         void StatusInit();
         bool ThreadExit();
         void HandleQueue();
-        bool GraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data);
+        bool GraphSubmit(vsi_nn_graph_t* graph, func_t func, data_t data,
+            Priority priority = Priority::NORMAL, bool block = true);
         bool GraphRemove(const vsi_nn_graph_t* graph);
         bool DeviceExit();
         bool ThreadIdle();
         void WaitThreadIdle();
 
     protected:
+        void MarkCompleted();
+        void SetAffinity(std::thread& thread);
+
         uint32_t id_;
-        std::array<std::thread, 2> threads_;
+        uint64_t cpu_mask_;
+        std::vector<std::thread> threads_;
         std::unique_ptr<GraphQueue> graphqueue_;
         std::unique_ptr<Worker> worker_;
+        /* Work items submitted and finished (run, removed or rejected),
+           the device is idle when they are equal. */
+        std::mutex idle_mtx_;
+        std::condition_variable idle_cv_;
+        size_t submitted_;
+        size_t completed_;
 };
 
 }  // namespace vip
@@ -141,6 +141,27 @@ static vsi_status vsi_nn_initOptions
         options->enable_dataconvert_optimize = atoi(env_s);
     }
 
+    env_s = NULL;
+    options->enable_dead_node_elimination = 0;
+    if (vsi_nn_getEnv("VSI_NN_ENABLE_DEAD_NODE_ELIMINATION", &env_s) && env_s)
+    {
+        options->enable_dead_node_elimination = atoi(env_s);
+    }
+
+    env_s = NULL;
+    options->enable_memory_schedule = 1;
+    if (vsi_nn_getEnv("VSI_NN_ENABLE_MEMORY_SCHEDULE", &env_s) && env_s)
+    {
+        options->enable_memory_schedule = atoi(env_s);
+    }
+
+    env_s = NULL;
+    options->enable_inplace_optimize = 0;
+    if (vsi_nn_getEnv("VSI_NN_ENABLE_INPLACE_OPTIMIZE", &env_s) && env_s)
+    {
+        options->enable_inplace_optimize = atoi(env_s);
+    }
+
     return VSI_SUCCESS;
 }
 
@@ -38,10 +38,11 @@
 #include "vsi_nn_version.h"
 #include "utils/vsi_nn_util.h"
 #include "utils/vsi_nn_vdata.h"
-#include "utils/vsi_nn_map.h"
+#include "utils/vsi_nn_table.h"
 #include "utils/vsi_nn_dtype_util.h"
 #include "vsi_nn_graph_optimization.h"
 #include "vsi_nn_error.h"
+#include "kernel/vsi_nn_kernel.h"
 
 static vsi_status _set_reference_node_name
     (
@@ -103,64 +104,6 @@ final:
     return status;
 } /* _set_reference_tensor_name() */
 
-static vsi_status _check_swapped_tensors
-    (
-    const vsi_nn_graph_t* graph
-    )
-{
-    uint32_t i = 0;
-    vsi_status status = VSI_SUCCESS;
-
-    VSILOGD("Check swapped tensors");
-    for( i = 0; i < graph->node_num; i++ )
-    {
-        vsi_nn_node_t* node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
-
-        /* For NBG node, all inputs/outputs need to be set if tensors are swapped */
-        if( node && VSI_NN_OP_NBG == node->op )
-        {
-            uint32_t idx, j;
-            vsi_nn_tensor_t* tensor = NULL;
-
-            idx = 0;
-            for( j = 0; j < node->input.num; j++ )
-            {
-                tensor = vsi_nn_GetTensor( graph, node->input.tensors[j] );
-                if( tensor && tensor->is_swapped )
-                {
-                    status = vxSetParameterByIndex( node->n, idx, (vx_reference)tensor->t );
-                    if( VSI_SUCCESS != status )
-                    {
-                        VSILOGE( "Set input parameter %d for node[%08x] fail!", idx, node->n );
-                        goto final;
-                    }
-                    tensor->is_swapped = FALSE;
-                }
-                idx++;
-            }
-
-            for( j = 0; j < node->output.num; j++ )
-            {
-                tensor = vsi_nn_GetTensor( graph, node->output.tensors[j] );
-                if( tensor && tensor->is_swapped )
-                {
-                    status = vxSetParameterByIndex( node->n, idx, (vx_reference)tensor->t );
-                    if( VSI_SUCCESS != status )
-                    {
-                        VSILOGE( "Set output parameter %d for node[%08x] fail!", idx, node->n );
-                        goto final;
-                    }
-                    tensor->is_swapped = FALSE;
-                }
-                idx++;
-            }
-        }
-    }
-
-final:
-    return status;
-} /* _check_swapped_tensors() */
-
 static void free_io_buffer
     (
     vsi_nn_tensor_t **buffer
@@ -375,12 +318,21 @@ static vsi_status compute_node
 
         /* Create vx node */
         VSILOGD("Instance node[%d] \"%s\" ...", node_id, vsi_nn_OpGetName(node->op));
+        node->kernel_types = 0;
+        graph->compute_node = node;
         status = vsi_nn_OpCompute( node->op, node, inputs, outputs );
+        graph->compute_node = NULL;
         if( VSI_SUCCESS != status )
         {
             VSILOGE( "Create node[%d] %s fail", node_id, vsi_nn_OpGetName(node->op));
             break;
         }
+        if( 0 == node->kernel_types
+         && ( NULL != node->n || NULL != node->internal_node_wksp ) )
+        {
+            /* Built from openvx builtin nodes without the kernel selector */
+            node->kernel_types = 1 << VSI_NN_KERNEL_TYPE_VX;
+        }
         status = _set_reference_node_name(graph, node);
         if( VSI_SUCCESS != status )
         {
@@ -551,6 +503,347 @@ final:
     free_io_buffer(outputs);
     return status;
 }
+#define _ADJACENCY_MIN_CAPACITY    (64)
+
+static vsi_bool _tensor_link_find
+    (
+    const vsi_nn_tensor_link_t * link,
+    vsi_nn_node_id_t             node_id,
+    uint32_t                   * pos
+    )
+{
+    uint32_t lo = 0;
+    uint32_t hi = link->num;
+    uint32_t mid;
+
+    while( lo < hi )
+    {
+        mid = lo + ( hi - lo ) / 2;
+        if( link->nodes[mid] < node_id )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    *pos = lo;
+    return lo < link->num && link->nodes[lo] == node_id;
+} /* _tensor_link_find() */
+
+static vsi_bool _tensor_link_add
+    (
+    vsi_nn_tensor_link_t * link,
+    vsi_nn_node_id_t       node_id
+    )
+{
+    uint32_t pos;
+    uint32_t capacity;
+    vsi_nn_node_id_t * nodes;
+    uint32_t * refs;
+
+    if( _tensor_link_find( link, node_id, &pos ) )
+    {
+        link->refs[pos] += 1;
+        return TRUE;
+    }
+    if( link->num == link->capacity )
+    {
+        capacity = link->capacity > 0 ? link->capacity * 2 : 4;
+        nodes = (vsi_nn_node_id_t *)realloc( link->nodes,
+            capacity * sizeof( vsi_nn_node_id_t ) );
+        if( NULL == nodes )
+        {
+            return FALSE;
+        }
+        link->nodes = nodes;
+        refs = (uint32_t *)realloc( link->refs, capacity * sizeof( uint32_t ) );
+        if( NULL == refs )
+        {
+            return FALSE;
+        }
+        link->refs = refs;
+        link->capacity = capacity;
+    }
+    memmove( &link->nodes[pos + 1], &link->nodes[pos],
+        ( link->num - pos ) * sizeof( vsi_nn_node_id_t ) );
+    memmove( &link->refs[pos + 1], &link->refs[pos],
+        ( link->num - pos ) * sizeof( uint32_t ) );
+    link->nodes[pos] = node_id;
+    link->refs[pos] = 1;
+    link->num += 1;
+    return TRUE;
+} /* _tensor_link_add() */
+
+static void _tensor_link_remove
+    (
+    vsi_nn_tensor_link_t * link,
+    vsi_nn_node_id_t       node_id
+    )
+{
+    uint32_t pos;
+
+    if( !_tensor_link_find( link, node_id, &pos ) )
+    {
+        return;
+    }
+    link->refs[pos] -= 1;
+    if( 0 == link->refs[pos] )
+    {
+        memmove( &link->nodes[pos], &link->nodes[pos + 1],
+            ( link->num - pos - 1 ) * sizeof( vsi_nn_node_id_t ) );
+        memmove( &link->refs[pos], &link->refs[pos + 1],
+            ( link->num - pos - 1 ) * sizeof( uint32_t ) );
+        link->num -= 1;
+    }
+} /* _tensor_link_remove() */
+
+static vsi_nn_tensor_adjacency_t * _get_tensor_adjacency
+    (
+    const vsi_nn_graph_t * graph,
+    vsi_nn_tensor_id_t     id
+    )
+{
+    if( NULL == graph || id >= graph->adjacency.capacity )
+    {
+        return NULL;
+    }
+    return &graph->adjacency.tensors[id];
+} /* _get_tensor_adjacency() */
+
+static vsi_nn_tensor_adjacency_t * _reserve_tensor_adjacency
+    (
+    vsi_nn_graph_t     * graph,
+    vsi_nn_tensor_id_t   id
+    )
+{
+    uint32_t capacity;
+    vsi_nn_tensor_adjacency_t * tensors;
+
+    if( id >= graph->adjacency.capacity )
+    {
+        capacity = graph->adjacency.capacity > 0 ?
+            graph->adjacency.capacity : _ADJACENCY_MIN_CAPACITY;
+        while( capacity <= id )
+        {
+            capacity *= 2;
+        }
+        tensors = (vsi_nn_tensor_adjacency_t *)realloc( graph->adjacency.tensors,
+            capacity * sizeof( vsi_nn_tensor_adjacency_t ) );
+        if( NULL == tensors )
+        {
+            VSILOGE( "Grow tensor adjacency to %u fail.", capacity );
+            return NULL;
+        }
+        memset( &tensors[graph->adjacency.capacity], 0,
+            ( capacity - graph->adjacency.capacity ) * sizeof( vsi_nn_tensor_adjacency_t ) );
+        graph->adjacency.tensors = tensors;
+        graph->adjacency.capacity = capacity;
+    }
+    return &graph->adjacency.tensors[id];
+} /* _reserve_tensor_adjacency() */
+
+static void _link_node_tensor
+    (
+    vsi_nn_graph_t     * graph,
+    vsi_nn_node_id_t     node_id,
+    vsi_nn_tensor_id_t   tensor_id,
+    vsi_bool             is_output,
+    vsi_bool             link
+    )
+{
+    vsi_nn_tensor_adjacency_t * adjacency;
+
+    if( VSI_NN_NODE_ID_NA == node_id || VSI_NN_TENSOR_ID_NA == tensor_id
+        || VSI_NN_TENSOR_ID_AUTO == tensor_id )
+    {
+        return;
+    }
+    if( link )
+    {
+        adjacency = _reserve_tensor_adjacency( graph, tensor_id );
+        if( NULL != adjacency )
+        {
+            _tensor_link_add( is_output ? &adjacency->providers
+                : &adjacency->consumers, node_id );
+        }
+    }
+    else
+    {
+        adjacency = _get_tensor_adjacency( graph, tensor_id );
+        if( NULL != adjacency )
+        {
+            _tensor_link_remove( is_output ? &adjacency->providers
+                : &adjacency->consumers, node_id );
+        }
+    }
+} /* _link_node_tensor() */
+
+static void _link_node
+    (
+    vsi_nn_graph_t * graph,
+    vsi_nn_node_t  * node,
+    vsi_bool         link
+    )
+{
+    uint32_t i;
+
+    for( i = 0; i < node->input.num; i++ )
+    {
+        _link_node_tensor( graph, node->id, node->input.tensors[i], FALSE, link );
+    }
+    for( i = 0; i < node->output.num; i++ )
+    {
+        _link_node_tensor( graph, node->id, node->output.tensors[i], TRUE, link );
+    }
+} /* _link_node() */
+
+static void _release_tensor_adjacency
+    (
+    vsi_nn_graph_t * graph
+    )
+{
+    uint32_t i;
+    vsi_nn_tensor_adjacency_t * adjacency;
+
+    for( i = 0; i < graph->adjacency.capacity; i++ )
+    {
+        adjacency = &graph->adjacency.tensors[i];
+        free( adjacency->consumers.nodes );
+        free( adjacency->consumers.refs );
+        free( adjacency->providers.nodes );
+        free( adjacency->providers.refs );
+    }
+    free( graph->adjacency.tensors );
+    graph->adjacency.tensors = NULL;
+    graph->adjacency.capacity = 0;
+} /* _release_tensor_adjacency() */
+
+static vsi_bool _node_has_tensor
+    (
+    const vsi_nn_node_t * node,
+    vsi_nn_tensor_id_t    id,
+    vsi_bool              is_output
+    )
+{
+    uint32_t i;
+    uint32_t num = is_output ? node->output.num : node->input.num;
+    const vsi_nn_tensor_id_t * tensors = is_output ?
+        node->output.tensors : node->input.tensors;
+
+    for( i = 0; i < num; i++ )
+    {
+        if( tensors[i] == id )
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+} /* _node_has_tensor() */
+
+static vsi_status _rebind_swapped_tensor
+    (
+    vsi_nn_node_t      * node,
+    vsi_nn_tensor_id_t   id,
+    vsi_nn_tensor_t    * tensor
+    )
+{
+    uint32_t idx, j;
+    vsi_status status = VSI_SUCCESS;
+
+    /* For NBG node, all inputs/outputs need to be set if tensors are swapped */
+    if( NULL == node || VSI_NN_OP_NBG != node->op )
+    {
+        return status;
+    }
+
+    idx = 0;
+    for( j = 0; j < node->input.num; j++ )
+    {
+        if( node->input.tensors[j] == id )
+        {
+            status = vxSetParameterByIndex( node->n, idx, (vx_reference)tensor->t );
+            if( VSI_SUCCESS != status )
+            {
+                VSILOGE( "Set input parameter %d for node[%08x] fail!", idx, node->n );
+                return status;
+            }
+        }
+        idx++;
+    }
+
+    for( j = 0; j < node->output.num; j++ )
+    {
+        if( node->output.tensors[j] == id )
+        {
+            status = vxSetParameterByIndex( node->n, idx, (vx_reference)tensor->t );
+            if( VSI_SUCCESS != status )
+            {
+                VSILOGE( "Set output parameter %d for node[%08x] fail!", idx, node->n );
+                return status;
+            }
+        }
+        idx++;
+    }
+    return status;
+} /* _rebind_swapped_tensor() */
+
+static vsi_status _check_swapped_tensors
+    (
+    const vsi_nn_graph_t* graph
+    )
+{
+    uint32_t i = 0;
+    uint32_t j = 0;
+    vsi_status status = VSI_SUCCESS;
+    vsi_nn_swapped_tensors_t* swapped = graph->swapped;
+    vsi_nn_tensor_adjacency_t* adjacency = NULL;
+    vsi_nn_tensor_t* tensor = NULL;
+    vsi_nn_tensor_id_t id;
+
+    if( NULL == swapped || 0 == swapped->num )
+    {
+        return status;
+    }
+
+    VSILOGD("Check %u swapped tensors", swapped->num);
+    for( i = 0; i < swapped->num; i++ )
+    {
+        id = swapped->tensors[i];
+        tensor = vsi_nn_GetTensor( graph, id );
+        if( NULL == tensor || !tensor->is_swapped )
+        {
+            continue;
+        }
+
+        adjacency = _get_tensor_adjacency( graph, id );
+        for( j = 0; NULL != adjacency && j < adjacency->consumers.num; j++ )
+        {
+            status = _rebind_swapped_tensor(
+                vsi_nn_GetNode( graph, adjacency->consumers.nodes[j] ), id, tensor );
+            if( VSI_SUCCESS != status )
+            {
+                goto final;
+            }
+        }
+        for( j = 0; NULL != adjacency && j < adjacency->providers.num; j++ )
+        {
+            status = _rebind_swapped_tensor(
+                vsi_nn_GetNode( graph, adjacency->providers.nodes[j] ), id, tensor );
+            if( VSI_SUCCESS != status )
+            {
+                goto final;
+            }
+        }
+        tensor->is_swapped = FALSE;
+    }
+    swapped->num = 0;
+
+final:
+    return status;
+} /* _check_swapped_tensors() */
+
 vsi_nn_graph_t * vsi_nn_CreateGraph
     (
     vsi_nn_context_t ctx,
@@ -591,11 +884,16 @@ vsi_nn_graph_t * vsi_nn_CreateGraph
             graph->node_num = 0;
             graph->ctx = ctx;
             graph->rnn_wksp = NULL;
-            graph->node_table = (vsi_nn_map_t *)malloc( sizeof( vsi_nn_map_t ) );
-            graph->tensor_table = (vsi_nn_map_t *)malloc( sizeof( vsi_nn_map_t ) );
+            graph->node_table = (vsi_nn_table_t *)malloc( sizeof( vsi_nn_table_t ) );
+            graph->tensor_table = (vsi_nn_table_t *)malloc( sizeof( vsi_nn_table_t ) );
             graph->isAllowFastMode = TRUE;
-            vsi_nn_MapInit( graph->node_table );
-            vsi_nn_MapInit( graph->tensor_table );
+            graph->swapped = (vsi_nn_swapped_tensors_t *)malloc( sizeof( vsi_nn_swapped_tensors_t ) );
+            vsi_nn_TableInit( graph->node_table );
+            vsi_nn_TableInit( graph->tensor_table );
+            if( NULL != graph->swapped )
+            {
+                memset( graph->swapped, 0, sizeof( vsi_nn_swapped_tensors_t ) );
+            }
         }
         else
         {
@@ -625,8 +923,18 @@ void vsi_nn_ReleaseGraph
             {
                 vsi_nn_RemoveNode( *graph, (vsi_nn_node_id_t)i );
             }
+            vsi_nn_TableDeinit( (*graph)->node_table );
             free( (*graph)->node_table );
         }
+        _release_tensor_adjacency( ptr );
+        vsi_nn_ReleaseMemoryPlan( &ptr->memory_plan );
+        free( ptr->exec_order );
+        free( ptr->inplace_source );
+        if( NULL != ptr->swapped )
+        {
+            free( ptr->swapped->tensors );
+            free( ptr->swapped );
+        }
         if( NULL != ptr->g )
         {
             vxReleaseGraph( &ptr->g );
@@ -637,6 +945,7 @@ void vsi_nn_ReleaseGraph
             {
                 vsi_nn_RemoveTensor( *graph, (vsi_nn_tensor_id_t)i );
             }
+            vsi_nn_TableDeinit( (*graph)->tensor_table );
             free( (*graph)->tensor_table );
         }
         if( ptr->complete_signal.exists
@@ -684,6 +993,9 @@ vsi_status vsi_nn_SetupGraph
         return status;
     }
 
+    /* Pick up node io written without the node io setters */
+    vsi_nn_RefreshTensorAdjacency( graph );
+
     /* Optimize graph */
     status = vsi_nn_OptimizeGraph(graph, &dirty);
     if(VSI_SUCCESS != status)
@@ -691,6 +1003,15 @@ vsi_status vsi_nn_SetupGraph
         goto final;
     }
 
+    if( graph->ctx->options.enable_dead_node_elimination )
+    {
+        status = vsi_nn_EliminateDeadNodes( graph, &graph->elimination );
+        if(VSI_SUCCESS != status)
+        {
+            goto final;
+        }
+    }
+
     /* Prepare node list */
     nodes_list = (vsi_nn_node_id_t *)malloc(
         graph->node_num * sizeof( vsi_nn_node_id_t ) );
@@ -733,6 +1054,15 @@ vsi_status vsi_nn_SetupGraph
         goto final;
     }
 
+    /* Shapes are known now, run the nodes in an order needing less memory */
+    if( ( TRUE == sort || dirty ) && graph->ctx->options.enable_memory_schedule )
+    {
+        if( VSI_SUCCESS != vsi_nn_ScheduleGraphMemory( graph, nodes_list, graph->node_num ) )
+        {
+            VSILOGW( "Schedule graph memory failure, keep the sorted order." );
+        }
+    }
+
     /* Optimize graph */
     status = optimize_node( graph, nodes_list );
     if(VSI_SUCCESS != status)
@@ -740,6 +1070,15 @@ vsi_status vsi_nn_SetupGraph
         goto final;
     }
 
+    if( graph->ctx->options.enable_inplace_optimize )
+    {
+        status = vsi_nn_InplaceOptimizeGraph( graph, nodes_list );
+        if(VSI_SUCCESS != status)
+        {
+            goto final;
+        }
+    }
+
     /* set tensor's precision before compute_node
     so that internal tensor can know the precision information*/
     status = set_graph_precision(graph, nodes_list);
@@ -762,6 +1101,13 @@ vsi_status vsi_nn_SetupGraph
         goto final;
     }
 
+    /* Keep the order, vsi_nn_GetGraphMemoryPlan() plans it on demand. */
+    vsi_nn_ReleaseMemoryPlan( &graph->memory_plan );
+    free( graph->exec_order );
+    graph->exec_order = nodes_list;
+    graph->exec_order_num = graph->node_num;
+    nodes_list = NULL;
+
     /* Try setup graph complete signal node. */
     status = vsi_nn_TrySetupCompleteSignalNode( graph );
     TEST_CHECK_STATUS( status, final );
@@ -967,9 +1313,16 @@ static vsi_nn_tensor_id_t _add_tensor
         tensor = vsi_nn_CreateTensor( graph, attr );
     }
 
+    if( NULL != tensor
+     && FALSE == vsi_nn_TableAdd( graph->tensor_table, (uint32_t)id, (void *)tensor ) )
+    {
+        vsi_nn_ReleaseTensor( &tensor );
+    }
+
     if( NULL != tensor )
     {
-        vsi_nn_MapAdd( graph->tensor_table, (vsi_nn_map_key_t)id, (void *)tensor );
+        tensor->graph = graph;
+        tensor->id = id;
         graph->cur_tid ++;
     }
     else
@@ -1019,8 +1372,17 @@ vsi_nn_tensor_id_t vsi_nn_AttachTensorToGraph
         id = graph->cur_tid;
         graph->tensor_num = graph->cur_tid;
     }
+    if( FALSE == vsi_nn_TableAdd( graph->tensor_table, (uint32_t)id, (void *)tensor ) )
+    {
+        return VSI_NN_TENSOR_ID_NA;
+    }
+    tensor->graph = graph;
+    tensor->id = id;
+    if( tensor->is_swapped )
+    {
+        vsi_nn_MarkTensorSwapped( graph, id );
+    }
     graph->cur_tid ++;
-    vsi_nn_MapAdd( graph->tensor_table, (vsi_nn_map_key_t)id, (void *)tensor );
     return id;
 } /* vsi_nn_AttachTensorToGraph() */
 
@@ -1049,8 +1411,7 @@ void vsi_nn_RemoveTensor
         if( NULL != tensor )
         {
             vsi_nn_ReleaseTensor( &tensor );
-            vsi_nn_MapRemove( graph->tensor_table,
-                    (vsi_nn_map_key_t)id );
+            vsi_nn_TableRemove( graph->tensor_table, (uint32_t)id );
         }
     }
 } /* vsi_nn_RemoveTensor() */
@@ -1065,7 +1426,7 @@ vsi_nn_tensor_t * vsi_nn_GetTensor
     tensor = NULL;
     if( NULL != graph )
     {
-        tensor = vsi_nn_MapGet( graph->tensor_table, (vsi_nn_map_key_t)id );
+        tensor = (vsi_nn_tensor_t *)vsi_nn_TableGet( graph->tensor_table, (uint32_t)id );
     }
     return tensor;
 } /* vsi_nn_GetTensor() */
@@ -1080,7 +1441,7 @@ vsi_nn_node_t * vsi_nn_GetNode
     node = NULL;
     if( NULL != graph )
     {
-        node = vsi_nn_MapGet( graph->node_table, (vsi_nn_map_key_t)id );
+        node = (vsi_nn_node_t *)vsi_nn_TableGet( graph->node_table, (uint32_t)id );
     }
     return node;
 } /* vsi_nn_GetTensor() */
@@ -1141,9 +1502,15 @@ vsi_nn_node_t * vsi_nn_AddNode
 
     id = graph->cur_nid;
     node = vsi_nn_NewNode(graph, op, input_num, output_num);
+    if( NULL != node
+     && FALSE == vsi_nn_TableAdd( graph->node_table, (uint32_t)id, (void *)node ) )
+    {
+        vsi_nn_ReleaseNode( &node );
+    }
+
     if( NULL != node )
     {
-        vsi_nn_MapAdd( graph->node_table, (vsi_nn_map_key_t)id, (void *)node );
+        node->id = id;
         graph->cur_nid ++;
         graph->node_num = graph->cur_nid;
     }
@@ -1222,8 +1589,13 @@ vsi_nn_node_t * vsi_nn_AddExternalNode
         node->attr.enable_op_constraint_check = TRUE;
     }
     id = graph->cur_nid;
+    if(NULL != node
+     && FALSE == vsi_nn_TableAdd( graph->node_table, (uint32_t)id, (void *)node )){
+        vsi_nn_ReleaseNode( &node );
+    }
     if(NULL != node){
-        vsi_nn_MapAdd( graph->node_table, (vsi_nn_map_key_t)id, (void *)node );
+        node->id = id;
+        _link_node( graph, node, TRUE );
         graph->node_num = graph->cur_nid;
         graph->cur_nid ++;
     }
@@ -1243,9 +1615,9 @@ void vsi_nn_RemoveNode
         node = vsi_nn_GetNode( graph, id );
         if( NULL != node )
         {
+            _link_node( graph, node, FALSE );
             vsi_nn_ReleaseNode( &node );
-            vsi_nn_MapRemove( graph->node_table,
-                    (vsi_nn_map_key_t)id );
+            vsi_nn_TableRemove( graph->node_table, (uint32_t)id );
         }
     }
 } /* vsi_nn_RemoveNode() */
@@ -1313,51 +1685,107 @@ vsi_bool vsi_nn_SetGraphOutputs
     return ret;
 } /* vsi_nn_SetGraphOutputs() */
 
-vsi_nn_node_id_t * vsi_nn_SortGraphNode
+static void _ready_heap_push
     (
-    vsi_nn_graph_t * graph
+    vsi_nn_node_id_t * heap,
+    uint32_t         * heap_size,
+    vsi_nn_node_id_t   node_id
     )
 {
-    uint32_t i,j;
-    uint32_t             count;
-    vsi_bool             dirty;
-    vsi_bool             all_tensor_processed;
-    vsi_bool           * tensors = NULL;
-    vsi_nn_node_id_t   * nodes = NULL;
-    vsi_nn_node_id_t   * sorted_nodes = NULL;
-    vsi_nn_node_t      * node = NULL;
-    vsi_nn_node_id_t     node_id;
-    vsi_nn_tensor_id_t   tensor_id;
-    vsi_nn_tensor_t    * tensor = NULL;
+    uint32_t i;
+    uint32_t parent;
 
-    if( NULL == graph || NULL == graph->nodes
-        || NULL == graph->tensors )
+    i = (*heap_size)++;
+    while( i > 0 )
     {
-        return NULL;
+        parent = ( i - 1 ) / 2;
+        if( heap[parent] <= node_id )
+        {
+            break;
+        }
+        heap[i] = heap[parent];
+        i = parent;
     }
+    heap[i] = node_id;
+} /* _ready_heap_push() */
 
-    tensors      = NULL;
-    sorted_nodes = NULL;
-    nodes        = NULL;
-    node         = NULL;
-    node_id      = VSI_NN_NODE_ID_NA;
-
-    /* Init variables. */
-    tensors = (vsi_bool *)malloc(
-        graph->tensor_num * sizeof( vsi_bool ) );
+static vsi_nn_node_id_t _ready_heap_pop
+    (
+    vsi_nn_node_id_t * heap,
+    uint32_t         * heap_size
+    )
+{
+    uint32_t i;
+    uint32_t child;
+    vsi_nn_node_id_t top;
+    vsi_nn_node_id_t last;
 
-    if( NULL == tensors )
+    top = heap[0];
+    last = heap[--(*heap_size)];
+    i = 0;
+    while( ( child = 2 * i + 1 ) < *heap_size )
     {
-        goto _SortGraphNodeFinally;
+        if( child + 1 < *heap_size && heap[child + 1] < heap[child] )
+        {
+            child ++;
+        }
+        if( last <= heap[child] )
+        {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return top;
+} /* _ready_heap_pop() */
+
+vsi_nn_node_id_t * vsi_nn_SortGraphNode
+    (
+    vsi_nn_graph_t * graph
+    )
+{
+    uint32_t i,j,k;
+    uint32_t             count;
+    uint32_t             heap_size;
+    vsi_bool           * tensors = NULL;
+    uint32_t           * pending = NULL;
+    uint32_t           * consumer_start = NULL;
+    vsi_nn_node_id_t   * consumers = NULL;
+    vsi_nn_node_id_t   * heap = NULL;
+    vsi_nn_node_id_t   * sorted_nodes = NULL;
+    vsi_nn_node_t      * node = NULL;
+    vsi_nn_node_id_t     node_id;
+    vsi_nn_tensor_id_t   tensor_id;
+    vsi_nn_tensor_t    * tensor = NULL;
+
+    if( NULL == graph || NULL == graph->nodes
+        || NULL == graph->tensors )
+    {
+        return NULL;
     }
 
+    /*
+     * Kahn's algorithm: a node becomes ready once every tensor it reads
+     * is produced, ready nodes are emitted smallest id first so the
+     * order is deterministic and follows the construction order.
+     */
+    tensors = (vsi_bool *)malloc(
+        ( graph->tensor_num + 1 ) * sizeof( vsi_bool ) );
+    consumer_start = (uint32_t *)calloc(
+        graph->tensor_num + 1, sizeof( uint32_t ) );
+    pending = (uint32_t *)calloc(
+        graph->node_num + 1, sizeof( uint32_t ) );
+    heap = (vsi_nn_node_id_t *)malloc(
+        ( graph->node_num + 1 ) * sizeof( vsi_nn_node_id_t ) );
     sorted_nodes = (vsi_nn_node_id_t *)malloc(
-        graph->node_num * sizeof( vsi_nn_node_id_t ) );
-    nodes = (vsi_nn_node_id_t *)malloc(
-        graph->node_num * sizeof( vsi_nn_node_id_t ) );
+        ( graph->node_num + 1 ) * sizeof( vsi_nn_node_id_t ) );
 
-    if( NULL == sorted_nodes || NULL == nodes)
+    if( NULL == tensors || NULL == consumer_start || NULL == pending
+        || NULL == heap || NULL == sorted_nodes )
     {
+        free( sorted_nodes );
+        sorted_nodes = NULL;
         goto _SortGraphNodeFinally;
     }
 
@@ -1378,70 +1806,114 @@ vsi_nn_node_id_t * vsi_nn_SortGraphNode
     for( i = 0; i < graph->input.num; i++ )
     {
         tensor_id = graph->input.tensors[i];
-        if( tensor_id != VSI_NN_TENSOR_ID_NA )
+        if( tensor_id < graph->tensor_num )
         {
             tensors[tensor_id] = TRUE;
         }
     }
 
+    /* Count the unready inputs of each node and build consumer lists. */
     for( i = 0; i < graph->node_num; i++ )
     {
-        nodes[i] = i;
+        node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
+        if( NULL == node )
+        {
+            continue;
+        }
+        for( j = 0; j < node->input.num; j ++ )
+        {
+            tensor_id = node->input.tensors[j];
+            if( tensor_id < graph->tensor_num && FALSE == tensors[tensor_id] )
+            {
+                pending[i] ++;
+                consumer_start[tensor_id + 1] ++;
+            }
+        }
+    }
+    for( i = 0; i < graph->tensor_num; i++ )
+    {
+        consumer_start[i + 1] += consumer_start[i];
+    }
+    consumers = (vsi_nn_node_id_t *)malloc(
+        ( consumer_start[graph->tensor_num] + 1 ) * sizeof( vsi_nn_node_id_t ) );
+    if( NULL == consumers )
+    {
+        free( sorted_nodes );
+        sorted_nodes = NULL;
+        goto _SortGraphNodeFinally;
     }
-    count = graph->node_num;
-    do
+    for( i = 0; i < graph->node_num; i++ )
     {
-        dirty = FALSE;
-        all_tensor_processed = FALSE;
-        for( i = 0; i < count; i ++ )
+        node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
+        if( NULL == node )
         {
-            node_id = nodes[i];
-            node = vsi_nn_GetNode( graph, node_id );
-            all_tensor_processed = TRUE;
-            for( j = 0; j < node->input.num; j ++ )
+            continue;
+        }
+        for( j = 0; j < node->input.num; j ++ )
+        {
+            tensor_id = node->input.tensors[j];
+            if( tensor_id < graph->tensor_num && FALSE == tensors[tensor_id] )
             {
-                tensor_id = node->input.tensors[j];
-                if( VSI_NN_TENSOR_ID_NA == tensor_id )
-                {
-                    continue;
-                }
-                if( FALSE == tensors[tensor_id] )
-                {
-                    all_tensor_processed = FALSE;
-                    break;
-                }
+                consumers[consumer_start[tensor_id]++] = i;
+            }
+        }
+    }
+    /* Filling advanced each start to the next one, shift them back. */
+    for( i = graph->tensor_num; i > 0; i-- )
+    {
+        consumer_start[i] = consumer_start[i - 1];
+    }
+    consumer_start[0] = 0;
+
+    heap_size = 0;
+    for( i = 0; i < graph->node_num; i++ )
+    {
+        if( 0 == pending[i] )
+        {
+            _ready_heap_push( heap, &heap_size, i );
+        }
+    }
+
+    count = 0;
+    while( heap_size > 0 )
+    {
+        node_id = _ready_heap_pop( heap, &heap_size );
+        sorted_nodes[count++] = node_id;
+        node = vsi_nn_GetNode( graph, node_id );
+        if( NULL == node )
+        {
+            continue;
+        }
+        for( j = 0; j < node->output.num; j ++ )
+        {
+            tensor_id = node->output.tensors[j];
+            if( tensor_id >= graph->tensor_num || TRUE == tensors[tensor_id] )
+            {
+                continue;
             }
-            if( TRUE == all_tensor_processed )
+            tensors[tensor_id] = TRUE;
+            for( k = consumer_start[tensor_id];
+                k < consumer_start[tensor_id + 1]; k ++ )
             {
-                sorted_nodes[graph->node_num - count] = nodes[i];
-                nodes[i] = nodes[count - 1];
-                count --;
-                i --;
-                dirty = TRUE;
-                for( j = 0; j < node->output.num; j ++ )
+                if( 0 == --pending[consumers[k]] )
                 {
-                    tensor_id = node->output.tensors[j];
-                    if( VSI_NN_TENSOR_ID_NA == tensor_id )
-                    {
-                        continue;
-                    }
-                    tensors[tensor_id] = TRUE;
+                    _ready_heap_push( heap, &heap_size, consumers[k] );
                 }
             }
         }
-        if( FALSE == dirty )
+    }
+
+    if( count != graph->node_num )
+    {
+        for( i = 0; i < graph->node_num; i++ )
         {
-            if( FALSE == all_tensor_processed )
+            if( pending[i] > 0 )
             {
                 // TODO: Log all unprocessed tensors
-                VSILOGW("Unprocessed node %u", node_id);
+                VSILOGW("Unprocessed node %u", i);
+                break;
             }
-            break;
         }
-    } while( count > 0 );
-
-    if( count != 0 )
-    {
         free( sorted_nodes );
         sorted_nodes = NULL;
     }
@@ -1450,7 +1922,10 @@ _SortGraphNodeFinally:
 
     /* Release memory. */
     free( tensors );
-    free( nodes );
+    free( pending );
+    free( consumer_start );
+    free( consumers );
+    free( heap );
     return sorted_nodes;
 } /* vsi_nn_SortGraphNode() */
 
@@ -2089,114 +2564,930 @@ vsi_bool vsi_nn_HasRNN
     return NULL != graph && NULL != graph->rnn_wksp;
 } /* vsi_nn_HasRNN() */
 
-void  vsi_nn_get_tensor_consumers
+vsi_status vsi_nn_SetNodeInput
     (
-    vsi_nn_graph_t* graph,
-    vsi_nn_tensor_id_t tensor_id,
-    vsi_nn_node_t** nodes,
-    uint32_t* count
+    vsi_nn_node_t      * node,
+    uint32_t             index,
+    vsi_nn_tensor_id_t   id
     )
 {
-    vsi_nn_node_t* node = NULL;
-    uint32_t i, j = 0;
-    uint32_t nodes_count = 0;
-    for(i = 0; i < graph->node_num; i++)
+    if( NULL == node || index >= node->input.num )
     {
-        node = vsi_nn_GetNode(graph, i);
-        for(j = 0; j < node->input.num; j++)
-        {
-            if(node->input.tensors[j] == tensor_id)
-            {
-                if(nodes != NULL)
-                {
-                    nodes[nodes_count] = node;
-                }
-                nodes_count += 1;
-                break;
-            }
-        }
+        return VSI_FAILURE;
     }
-    if(count != NULL)
+    if( NULL != node->graph )
     {
-        *count = nodes_count;
+        _link_node_tensor( node->graph, node->id, node->input.tensors[index], FALSE, FALSE );
+        _link_node_tensor( node->graph, node->id, id, FALSE, TRUE );
     }
-} /* vsi_nn_get_tensor_consumers() */
+    node->input.tensors[index] = id;
+    return VSI_SUCCESS;
+} /* vsi_nn_SetNodeInput() */
 
-void vsi_nn_get_tensor_provider
+vsi_status vsi_nn_SetNodeOutput
     (
-    vsi_nn_graph_t* graph,
-    vsi_nn_tensor_id_t tensor_id,
-    vsi_nn_node_t** node
+    vsi_nn_node_t      * node,
+    uint32_t             index,
+    vsi_nn_tensor_id_t   id
     )
 {
-    vsi_nn_node_t* cur_node = NULL;
-    uint32_t i, j = 0;
-    for(i = 0; i < graph->node_num; i++)
+    if( NULL == node || index >= node->output.num )
+    {
+        return VSI_FAILURE;
+    }
+    if( NULL != node->graph )
+    {
+        _link_node_tensor( node->graph, node->id, node->output.tensors[index], TRUE, FALSE );
+        _link_node_tensor( node->graph, node->id, id, TRUE, TRUE );
+    }
+    node->output.tensors[index] = id;
+    return VSI_SUCCESS;
+} /* vsi_nn_SetNodeOutput() */
+
+vsi_status vsi_nn_RefreshTensorAdjacency
+    (
+    vsi_nn_graph_t * graph
+    )
+{
+    uint32_t i;
+    vsi_nn_node_t * node;
+
+    if( NULL == graph )
+    {
+        return VSI_FAILURE;
+    }
+    for( i = 0; i < graph->adjacency.capacity; i++ )
+    {
+        graph->adjacency.tensors[i].consumers.num = 0;
+        graph->adjacency.tensors[i].providers.num = 0;
+    }
+    for( i = 0; i < graph->node_num; i++ )
     {
-        cur_node = vsi_nn_GetNode(graph, i);
-        for(j = 0; j < cur_node->output.num; j++)
+        node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
+        if( NULL != node )
         {
-            if(cur_node->output.tensors[j] == tensor_id)
-            {
-                *node = cur_node;
-                return;
-            }
+            _link_node( graph, node, TRUE );
         }
     }
-} /* vsi_nn_get_tensor_provider() */
+    return VSI_SUCCESS;
+} /* vsi_nn_RefreshTensorAdjacency() */
 
-vsi_status vsi_nn_SetGraphPreloadSize
+static void _compact_graph_nodes
     (
-    vsi_nn_graph_t* graph,
-    vsi_nn_graph_attr_preload_type_e attr,
-    uint32_t size
+    vsi_nn_graph_t * graph
     )
 {
-    vsi_status status;
-    status = VSI_FAILURE;
+    uint32_t i;
+    uint32_t num;
+    vsi_nn_node_t * node;
 
-#if(defined(VX_PRELOAD_CONST_TENSOR_SUPPORT) && VX_PRELOAD_CONST_TENSOR_SUPPORT)
-    if(graph && graph->g)
+    num = 0;
+    for( i = 0; i < graph->node_num; i++ )
     {
-        switch(attr)
+        node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
+        if( NULL == node )
         {
-            case VSI_NN_GRAPH_PRELOAD_VIPSRAM:
+            continue;
+        }
+        if( i != num )
+        {
+            vsi_nn_TableRemove( graph->node_table, i );
+            vsi_nn_TableAdd( graph->node_table, num, node );
+            node->id = num;
+        }
+        num ++;
+    }
+    graph->node_num = num;
+    graph->cur_nid = num;
+    vsi_nn_RefreshTensorAdjacency( graph );
+} /* _compact_graph_nodes() */
+
+vsi_status vsi_nn_EliminateDeadNodes
+    (
+    vsi_nn_graph_t * graph,
+    vsi_nn_elimination_report_t * report
+    )
+{
+    uint32_t i, j;
+    uint32_t stack_size;
+    vsi_bool * node_live = NULL;
+    vsi_bool * tensor_live = NULL;
+    vsi_nn_tensor_id_t * stack = NULL;
+    vsi_nn_tensor_id_t id;
+    vsi_nn_tensor_adjacency_t * adjacency;
+    vsi_nn_tensor_t * tensor;
+    vsi_nn_node_t * node;
+    vsi_nn_elimination_report_t result;
+    vsi_status status = VSI_FAILURE;
+
+    memset( &result, 0, sizeof( result ) );
+    if( NULL == graph )
+    {
+        goto final;
+    }
+    if( 0 == graph->output.num )
+    {
+        /* Nothing is known to be live */
+        status = VSI_SUCCESS;
+        goto final;
+    }
+
+    node_live = (vsi_bool *)calloc( graph->node_num + 1, sizeof( vsi_bool ) );
+    tensor_live = (vsi_bool *)calloc( graph->tensor_num + 1, sizeof( vsi_bool ) );
+    stack = (vsi_nn_tensor_id_t *)malloc(
+        ( graph->tensor_num + 1 ) * sizeof( vsi_nn_tensor_id_t ) );
+    if( NULL == node_live || NULL == tensor_live || NULL == stack )
+    {
+        goto final;
+    }
+
+    /* Graph outputs and tensors readable by the user are live */
+    stack_size = 0;
+    for( i = 0; i < graph->tensor_num; i++ )
+    {
+        tensor = vsi_nn_GetTensor( graph, (vsi_nn_tensor_id_t)i );
+        if( NULL != tensor && !tensor->attr.vtl && !tensor->attr.is_const )
+        {
+            tensor_live[i] = TRUE;
+            stack[stack_size++] = (vsi_nn_tensor_id_t)i;
+        }
+    }
+    for( i = 0; i < graph->output.num; i++ )
+    {
+        id = graph->output.tensors[i];
+        if( id < graph->tensor_num && !tensor_live[id] )
+        {
+            tensor_live[id] = TRUE;
+            stack[stack_size++] = id;
+        }
+    }
+
+    /* Walk back from live tensors through their providers */
+    while( stack_size > 0 )
+    {
+        id = stack[--stack_size];
+        adjacency = _get_tensor_adjacency( graph, id );
+        if( NULL == adjacency )
+        {
+            continue;
+        }
+        for( i = 0; i < adjacency->providers.num; i++ )
+        {
+            node = vsi_nn_GetNode( graph, adjacency->providers.nodes[i] );
+            if( NULL == node || node_live[node->id] )
             {
-                status = vxSetGraphAttribute(graph->g, VX_GRAPH_VIP_SRAM_PRE_LOAD, &size, sizeof(size));
-                break;
+                continue;
             }
-
-            case VSI_NN_GRAPH_PRELOAD_AXISRAM:
+            node_live[node->id] = TRUE;
+            for( j = 0; j < node->input.num; j++ )
             {
-                status = vxSetGraphAttribute(graph->g, VX_GRAPH_AXI_SRAM_PRE_LOAD, &size, sizeof(size));
-                break;
+                id = node->input.tensors[j];
+                if( id < graph->tensor_num && !tensor_live[id] )
+                {
+                    tensor_live[id] = TRUE;
+                    stack[stack_size++] = id;
+                }
             }
-
-            default:
+            /* Unused outputs of live nodes are still written */
+            for( j = 0; j < node->output.num; j++ )
             {
-                VSILOGE("Unsupported graph attribute: %d", attr);
-                break;
+                id = node->output.tensors[j];
+                if( id < graph->tensor_num )
+                {
+                    tensor_live[id] = TRUE;
+                }
             }
         }
     }
-#else
-    status = VSI_SUCCESS;
-#endif
-
-    return status;
-}
 
-vsi_nn_tensor_id_t vsi_nn_get_tensor_id
-    (
-    vsi_nn_graph_t* graph,
-    const vsi_nn_tensor_t * tensor
-    )
-{
-    uint32_t i;
-    vsi_nn_tensor_t * iter;
-    if( !graph || !tensor )
+    for( i = 0; i < graph->node_num; i++ )
     {
-        return VSI_NN_TENSOR_ID_NA;
+        node = vsi_nn_GetNode( graph, (vsi_nn_node_id_t)i );
+        if( NULL != node && !node_live[i] )
+        {
+            VSILOGD( "Remove dead node[%u] %s", i, vsi_nn_OpGetName( node->op ) );
+            vsi_nn_RemoveNode( graph, (vsi_nn_node_id_t)i );
+            result.removed_nodes ++;
+        }
+    }
+    for( i = 0; i < graph->input.num; i++ )
+    {
+        id = graph->input.tensors[i];
+        if( id < graph->tensor_num )
+        {
+            tensor_live[id] = TRUE;
+        }
+    }
+    for( i = 0; i < graph->tensor_num; i++ )
+    {
+        tensor = vsi_nn_GetTensor( graph, (vsi_nn_tensor_id_t)i );
+        if( NULL == tensor || tensor_live[i]
+         || ( !tensor->attr.vtl && !tensor->attr.is_const ) )
+        {
+            continue;
+        }
+        if( tensor->attr.vtl )
+        {
+            result.saved_bytes += vsi_nn_GetTensorSize( tensor->attr.size,
+                tensor->attr.dim_num, tensor->attr.dtype.vx_type );
+        }
+        vsi_nn_RemoveTensor( graph, (vsi_nn_tensor_id_t)i );
+        result.removed_tensors ++;
+    }
+
+    if( result.removed_nodes > 0 )
+    {
+        _compact_graph_nodes( graph );
+        VSILOGI( "Eliminated %u dead nodes and %u tensors, %"VSI_SIZE_T_SPECIFIER" bytes saved",
+            result.removed_nodes, result.removed_tensors, result.saved_bytes );
+    }
+    status = VSI_SUCCESS;
+
+final:
+    if( NULL != node_live )
+    {
+        free( node_live );
+    }
+    if( NULL != tensor_live )
+    {
+        free( tensor_live );
+    }
+    if( NULL != stack )
+    {
+        free( stack );
+    }
+    if( NULL != report )
+    {
+        *report = result;
+    }
+    return status;
+} /* vsi_nn_EliminateDeadNodes() */
+
+#define _MEMORY_PLAN_ALIGNMENT     (64)
+#define _MEMORY_PLAN_ALIGN( x ) \
+    ( ( ( x ) + _MEMORY_PLAN_ALIGNMENT - 1 ) / _MEMORY_PLAN_ALIGNMENT * _MEMORY_PLAN_ALIGNMENT )
+
+static vsi_size_t _virtual_tensor_size
+    (
+    vsi_nn_graph_t     * graph,
+    vsi_nn_tensor_id_t   id
+    )
+{
+    vsi_nn_tensor_t * tensor;
+
+    if( id >= graph->tensor_num )
+    {
+        return 0;
+    }
+    tensor = vsi_nn_GetTensor( graph, id );
+    if( NULL == tensor || !tensor->attr.vtl || tensor->attr.is_const )
+    {
+        return 0;
+    }
+    return vsi_nn_GetTensorSize( tensor->attr.size,
+        tensor->attr.dim_num, tensor->attr.dtype.vx_type );
+} /* _virtual_tensor_size() */
+
+static void _touch_memory_block
+    (
+    vsi_nn_graph_t        * graph,
+    vsi_nn_memory_plan_t  * plan,
+    uint32_t              * index,
+    vsi_nn_tensor_id_t      id,
+    uint32_t                position
+    )
+{
+    vsi_size_t size;
+    vsi_nn_memory_block_t * block;
+
+    if( id >= graph->tensor_num )
+    {
+        return;
+    }
+    /* An in-place output lives in the buffer of the tensor it writes over */
+    while( id < graph->inplace_source_num
+        && VSI_NN_TENSOR_ID_NA != graph->inplace_source[id] )
+    {
+        id = graph->inplace_source[id];
+    }
+    if( index[id] > 0 )
+    {
+        plan->blocks[index[id] - 1].last = position;
+        return;
+    }
+    size = _virtual_tensor_size( graph, id );
+    if( 0 == size )
+    {
+        return;
+    }
+    block = &plan->blocks[plan->block_num];
+    block->tensor = id;
+    block->first = position;
+    block->last = position;
+    block->size = size;
+    block->offset = 0;
+    plan->total_bytes += size;
+    index[id] = ++plan->block_num;
+} /* _touch_memory_block() */
+
+/*
+ * Fill the live range of every virtual tensor over the node order and
+ * the peak of the live bytes, blocks are not packed.
+ */
+static vsi_status _plan_live_ranges
+    (
+    vsi_nn_graph_t         * graph,
+    const vsi_nn_node_id_t * nodes,
+    uint32_t                 node_num,
+    vsi_nn_memory_plan_t   * plan
+    )
+{
+    uint32_t i, j;
+    uint32_t * index = NULL;
+    vsi_size_t * starts = NULL;
+    vsi_size_t * ends = NULL;
+    vsi_size_t live;
+    vsi_nn_node_t * node;
+    vsi_status status = VSI_FAILURE;
+
+    memset( plan, 0, sizeof( vsi_nn_memory_plan_t ) );
+    index = (uint32_t *)calloc( graph->tensor_num + 1, sizeof( uint32_t ) );
+    starts = (vsi_size_t *)calloc( node_num + 1, sizeof( vsi_size_t ) );
+    ends = (vsi_size_t *)calloc( node_num + 1, sizeof( vsi_size_t ) );
+    plan->blocks = (vsi_nn_memory_block_t *)malloc(
+        ( graph->tensor_num + 1 ) * sizeof( vsi_nn_memory_block_t ) );
+    if( NULL == index || NULL == starts || NULL == ends || NULL == plan->blocks )
+    {
+        goto final;
+    }
+
+    for( i = 0; i < node_num; i++ )
+    {
+        node = vsi_nn_GetNode( graph, nodes[i] );
+        if( NULL == node )
+        {
+            continue;
+        }
+        for( j = 0; j < node->output.num; j++ )
+        {
+            _touch_memory_block( graph, plan, index, node->output.tensors[j], i );
+        }
+        for( j = 0; j < node->input.num; j++ )
+        {
+            _touch_memory_block( graph, plan, index, node->input.tensors[j], i );
+        }
+    }
+
+    /* A block is live from its first to its last position, both included */
+    for( i = 0; i < plan->block_num; i++ )
+    {
+        starts[plan->blocks[i].first] += plan->blocks[i].size;
+        ends[plan->blocks[i].last] += plan->blocks[i].size;
+    }
+    live = 0;
+    for( i = 0; i < node_num; i++ )
+    {
+        live += starts[i];
+        plan->peak_bytes = vsi_nn_max( plan->peak_bytes, live );
+        live -= ends[i];
+    }
+    status = VSI_SUCCESS;
+
+final:
+    if( VSI_SUCCESS != status )
+    {
+        vsi_nn_ReleaseMemoryPlan( plan );
+    }
+    free( index );
+    free( starts );
+    free( ends );
+    return status;
+} /* _plan_live_ranges() */
+
+static int _compare_block_size
+    (
+    const void * a,
+    const void * b
+    )
+{
+    const vsi_nn_memory_block_t * x = *(const vsi_nn_memory_block_t * const *)a;
+    const vsi_nn_memory_block_t * y = *(const vsi_nn_memory_block_t * const *)b;
+
+    if( x->size != y->size )
+    {
+        return x->size > y->size ? -1 : 1;
+    }
+    if( x->first != y->first )
+    {
+        return x->first < y->first ? -1 : 1;
+    }
+    return 0;
+} /* _compare_block_size() */
+
+static int _compare_block_offset
+    (
+    const void * a,
+    const void * b
+    )
+{
+    const vsi_nn_memory_block_t * x = *(const vsi_nn_memory_block_t * const *)a;
+    const vsi_nn_memory_block_t * y = *(const vsi_nn_memory_block_t * const *)b;
+
+    if( x->offset != y->offset )
+    {
+        return x->offset < y->offset ? -1 : 1;
+    }
+    return 0;
+} /* _compare_block_offset() */
+
+vsi_status vsi_nn_PlanGraphMemory
+    (
+    vsi_nn_graph_t * graph,
+    const vsi_nn_node_id_t * nodes,
+    uint32_t node_num,
+    vsi_nn_memory_plan_t * plan
+    )
+{
+    uint32_t i, j;
+    uint32_t conflict_num;
+    vsi_size_t offset;
+    vsi_nn_node_id_t * sorted_nodes = NULL;
+    vsi_nn_memory_block_t ** order = NULL;
+    vsi_nn_memory_block_t ** conflicts = NULL;
+    vsi_nn_memory_block_t * block;
+    vsi_status status = VSI_FAILURE;
+
+    if( NULL == graph || NULL == plan )
+    {
+        return status;
+    }
+    memset( plan, 0, sizeof( vsi_nn_memory_plan_t ) );
+    if( NULL == nodes )
+    {
+        sorted_nodes = vsi_nn_SortGraphNode( graph );
+        if( NULL == sorted_nodes )
+        {
+            goto final;
+        }
+        nodes = sorted_nodes;
+        node_num = graph->node_num;
+    }
+
+    status = _plan_live_ranges( graph, nodes, node_num, plan );
+    if( VSI_SUCCESS != status || 0 == plan->block_num )
+    {
+        goto final;
+    }
+    status = VSI_FAILURE;
+    order = (vsi_nn_memory_block_t **)malloc(
+        plan->block_num * sizeof( vsi_nn_memory_block_t * ) );
+    conflicts = (vsi_nn_memory_block_t **)malloc(
+        plan->block_num * sizeof( vsi_nn_memory_block_t * ) );
+    if( NULL == order || NULL == conflicts )
+    {
+        vsi_nn_ReleaseMemoryPlan( plan );
+        goto final;
+    }
+
+    /*
+     * Largest blocks first, each goes to the lowest aligned offset where it
+     * overlaps none of the placed blocks live at the same time.
+     */
+    for( i = 0; i < plan->block_num; i++ )
+    {
+        order[i] = &plan->blocks[i];
+    }
+    qsort( order, plan->block_num, sizeof( vsi_nn_memory_block_t * ),
+        _compare_block_size );
+    for( i = 0; i < plan->block_num; i++ )
+    {
+        block = order[i];
+        conflict_num = 0;
+        for( j = 0; j < i; j++ )
+        {
+            if( order[j]->first <= block->last && block->first <= order[j]->last )
+            {
+                conflicts[conflict_num++] = order[j];
+            }
+        }
+        qsort( conflicts, conflict_num, sizeof( vsi_nn_memory_block_t * ),
+            _compare_block_offset );
+        offset = 0;
+        for( j = 0; j < conflict_num; j++ )
+        {
+            if( offset + block->size <= conflicts[j]->offset )
+            {
+                break;
+            }
+            offset = vsi_nn_max( offset,
+                _MEMORY_PLAN_ALIGN( conflicts[j]->offset + conflicts[j]->size ) );
+        }
+        block->offset = offset;
+        plan->arena_bytes = vsi_nn_max( plan->arena_bytes, offset + block->size );
+    }
+    status = VSI_SUCCESS;
+
+final:
+    free( sorted_nodes );
+    free( order );
+    free( conflicts );
+    return status;
+} /* vsi_nn_PlanGraphMemory() */
+
+void vsi_nn_ReleaseMemoryPlan
+    (
+    vsi_nn_memory_plan_t * plan
+    )
+{
+    if( NULL != plan )
+    {
+        free( plan->blocks );
+        memset( plan, 0, sizeof( vsi_nn_memory_plan_t ) );
+    }
+} /* vsi_nn_ReleaseMemoryPlan() */
+
+const vsi_nn_memory_plan_t * vsi_nn_GetGraphMemoryPlan
+    (
+    vsi_nn_graph_t * graph
+    )
+{
+    vsi_status status;
+
+    if( NULL == graph )
+    {
+        return NULL;
+    }
+    if( NULL != graph->exec_order )
+    {
+        status = vsi_nn_PlanGraphMemory( graph, graph->exec_order,
+            graph->exec_order_num, &graph->memory_plan );
+        if( VSI_SUCCESS != status )
+        {
+            return NULL;
+        }
+        free( graph->exec_order );
+        graph->exec_order = NULL;
+        graph->exec_order_num = 0;
+    }
+    return &graph->memory_plan;
+} /* vsi_nn_GetGraphMemoryPlan() */
+
+/*
+ * Bytes the node adds to the live virtual tensors: what it writes minus
+ * what it reads for the last time. Tensors are counted once per node.
+ */
+static int64_t _node_memory_delta
+    (
+    vsi_nn_graph_t * graph,
+    vsi_nn_node_t  * node,
+    const uint32_t * readers,
+    uint32_t       * stamp,
+    uint32_t         mark
+    )
+{
+    uint32_t i;
+    int64_t delta;
+    vsi_nn_tensor_id_t id;
+
+    delta = 0;
+    for( i = 0; i < node->output.num; i++ )
+    {
+        id = node->output.tensors[i];
+        if( id < graph->tensor_num && stamp[id] != mark )
+        {
+            stamp[id] = mark;
+            delta += (int64_t)_virtual_tensor_size( graph, id );
+        }
+    }
+    for( i = 0; i < node->input.num; i++ )
+    {
+        id = node->input.tensors[i];
+        if( id < graph->tensor_num && stamp[id] != mark )
+        {
+            stamp[id] = mark;
+            if( 1 == readers[id] )
+            {
+                delta -= (int64_t)_virtual_tensor_size( graph, id );
+            }
+        }
+    }
+    return delta;
+} /* _node_memory_delta() */
+
+vsi_status vsi_nn_ScheduleGraphMemory
+    (
+    vsi_nn_graph_t * graph,
+    vsi_nn_node_id_t * nodes,
+    uint32_t node_num
+    )
+{
+    uint32_t i, j, k;
+    uint32_t count;
+    uint32_t ready_num;
+    uint32_t best;
+    uint32_t mark;
+    int64_t delta;
+    int64_t best_delta;
+    uint32_t * position = NULL;
+    uint32_t * pending = NULL;
+    uint32_t * readers = NULL;
+    uint32_t * stamp = NULL;
+    vsi_nn_node_id_t * ready = NULL;
+    vsi_nn_node_id_t * scheduled = NULL;
+    vsi_nn_node_id_t node_id;
+    vsi_nn_node_t * node;
+    vsi_nn_tensor_id_t id;
+    vsi_nn_tensor_adjacency_t * adjacency;
+    vsi_nn_memory_plan_t before;
+    vsi_nn_memory_plan_t after;
+    vsi_status status = VSI_FAILURE;
+
+    memset( &before, 0, sizeof( before ) );
+    memset( &after, 0, sizeof( after ) );
+    if( NULL == graph || NULL == nodes || node_num > graph->node_num )
+    {
+        return status;
+    }
+    if( node_num < 2 )
+    {
+        return VSI_SUCCESS;
+    }
+
+    position = (uint32_t *)malloc( ( graph->node_num + 1 ) * sizeof( uint32_t ) );
+    pending = (uint32_t *)calloc( graph->node_num + 1, sizeof( uint32_t ) );
+    readers = (uint32_t *)calloc( graph->tensor_num + 1, sizeof( uint32_t ) );
+    stamp = (uint32_t *)calloc( graph->tensor_num + 1, sizeof( uint32_t ) );
+    ready = (vsi_nn_node_id_t *)malloc( node_num * sizeof( vsi_nn_node_id_t ) );
+    scheduled = (vsi_nn_node_id_t *)malloc( node_num * sizeof( vsi_nn_node_id_t ) );
+    if( NULL == position || NULL == pending || NULL == readers
+        || NULL == stamp || NULL == ready || NULL == scheduled )
+    {
+        goto final;
+    }
+
+    /* Count the produced inputs each node waits for and the readers of each tensor */
+    mark = 0;
+    for( i = 0; i < node_num; i++ )
+    {
+        position[nodes[i]] = i;
+        node = vsi_nn_GetNode( graph, nodes[i] );
+        if( NULL == node )
+        {
+            continue;
+        }
+        mark ++;
+        for( j = 0; j < node->input.num; j++ )
+        {
+            id = node->input.tensors[j];
+            if( id >= graph->tensor_num || stamp[id] == mark )
+            {
+                continue;
+            }
+            stamp[id] = mark;
+            readers[id] ++;
+            adjacency = _get_tensor_adjacency( graph, id );
+            if( NULL != adjacency && adjacency->providers.num > 0 )
+            {
+                pending[nodes[i]] ++;
+            }
+        }
+    }
+
+    ready_num = 0;
+    for( i = 0; i < node_num; i++ )
+    {
+        if( 0 == pending[nodes[i]] )
+        {
+            ready[ready_num++] = nodes[i];
+        }
+    }
+
+    count = 0;
+    while( ready_num > 0 )
+    {
+        best = 0;
+        best_delta = 0;
+        for( i = 0; i < ready_num; i++ )
+        {
+            node = vsi_nn_GetNode( graph, ready[i] );
+            delta = NULL == node ? 0
+                : _node_memory_delta( graph, node, readers, stamp, ++mark );
+            if( 0 == i || delta < best_delta
+             || ( delta == best_delta && position[ready[i]] < position[ready[best]] ) )
+            {
+                best = i;
+                best_delta = delta;
+            }
+        }
+        node_id = ready[best];
+        ready[best] = ready[--ready_num];
+        scheduled[count++] = node_id;
+
+        node = vsi_nn_GetNode( graph, node_id );
+        if( NULL == node )
+        {
+            continue;
+        }
+        mark ++;
+        for( j = 0; j < node->input.num; j++ )
+        {
+            id = node->input.tensors[j];
+            if( id < graph->tensor_num && stamp[id] != mark )
+            {
+                stamp[id] = mark;
+                readers[id] --;
+            }
+        }
+        for( j = 0; j < node->output.num; j++ )
+        {
+            adjacency = _get_tensor_adjacency( graph, node->output.tensors[j] );
+            if( NULL == adjacency )
+            {
+                continue;
+            }
+            for( k = 0; k < adjacency->consumers.num; k++ )
+            {
+                node_id = adjacency->consumers.nodes[k];
+                if( node_id < graph->node_num && pending[node_id] > 0
+                 && 0 == --pending[node_id] )
+                {
+                    ready[ready_num++] = node_id;
+                }
+            }
+        }
+    }
+    if( count != node_num )
+    {
+        VSILOGW( "Schedule %u of %u nodes, the graph has a cycle.", count, node_num );
+        goto final;
+    }
+
+    status = _plan_live_ranges( graph, nodes, node_num, &before );
+    TEST_CHECK_STATUS( status, final );
+    status = _plan_live_ranges( graph, scheduled, node_num, &after );
+    TEST_CHECK_STATUS( status, final );
+    if( after.peak_bytes < before.peak_bytes )
+    {
+        VSILOGD( "Memory schedule lowers peak from %"VSI_SIZE_T_SPECIFIER" to %"VSI_SIZE_T_SPECIFIER" bytes",
+            before.peak_bytes, after.peak_bytes );
+        memcpy( nodes, scheduled, node_num * sizeof( vsi_nn_node_id_t ) );
+    }
+
+final:
+    vsi_nn_ReleaseMemoryPlan( &before );
+    vsi_nn_ReleaseMemoryPlan( &after );
+    free( position );
+    free( pending );
+    free( readers );
+    free( stamp );
+    free( ready );
+    free( scheduled );
+    return status;
+} /* vsi_nn_ScheduleGraphMemory() */
+
+vsi_status vsi_nn_MarkTensorSwapped
+    (
+    vsi_nn_graph_t     * graph,
+    vsi_nn_tensor_id_t   id
+    )
+{
+    uint32_t capacity;
+    vsi_nn_tensor_id_t * tensors;
+    vsi_nn_swapped_tensors_t * swapped;
+
+    if( NULL == graph || NULL == graph->swapped )
+    {
+        return VSI_FAILURE;
+    }
+    swapped = graph->swapped;
+    if( swapped->num == swapped->capacity )
+    {
+        capacity = swapped->capacity > 0 ? swapped->capacity * 2 : 8;
+        tensors = (vsi_nn_tensor_id_t *)realloc( swapped->tensors,
+            capacity * sizeof( vsi_nn_tensor_id_t ) );
+        if( NULL == tensors )
+        {
+            VSILOGE( "Grow swapped tensor list to %u fail.", capacity );
+            return VSI_FAILURE;
+        }
+        swapped->tensors = tensors;
+        swapped->capacity = capacity;
+    }
+    swapped->tensors[swapped->num++] = id;
+    return VSI_SUCCESS;
+} /* vsi_nn_MarkTensorSwapped() */
+
+void  vsi_nn_get_tensor_consumers
+    (
+    vsi_nn_graph_t* graph,
+    vsi_nn_tensor_id_t tensor_id,
+    vsi_nn_node_t** nodes,
+    uint32_t* count
+    )
+{
+    vsi_nn_node_t* node = NULL;
+    vsi_nn_tensor_adjacency_t* adjacency = NULL;
+    uint32_t i;
+    uint32_t nodes_count = 0;
+
+    adjacency = _get_tensor_adjacency(graph, tensor_id);
+    for(i = 0; NULL != adjacency && i < adjacency->consumers.num; i++)
+    {
+        node = vsi_nn_GetNode(graph, adjacency->consumers.nodes[i]);
+        if(NULL != node && _node_has_tensor(node, tensor_id, FALSE))
+        {
+            if(nodes != NULL)
+            {
+                nodes[nodes_count] = node;
+            }
+            nodes_count += 1;
+        }
+    }
+    if(count != NULL)
+    {
+        *count = nodes_count;
+    }
+} /* vsi_nn_get_tensor_consumers() */
+
+void vsi_nn_get_tensor_provider
+    (
+    vsi_nn_graph_t* graph,
+    vsi_nn_tensor_id_t tensor_id,
+    vsi_nn_node_t** node
+    )
+{
+    vsi_nn_node_t* cur_node = NULL;
+    vsi_nn_tensor_adjacency_t* adjacency = NULL;
+    uint32_t i;
+
+    adjacency = _get_tensor_adjacency(graph, tensor_id);
+    for(i = 0; NULL != adjacency && i < adjacency->providers.num; i++)
+    {
+        cur_node = vsi_nn_GetNode(graph, adjacency->providers.nodes[i]);
+        if(NULL != cur_node && _node_has_tensor(cur_node, tensor_id, TRUE))
+        {
+            *node = cur_node;
+            return;
+        }
+    }
+} /* vsi_nn_get_tensor_provider() */
+
+vsi_status vsi_nn_SetGraphPreloadSize
+    (
+    vsi_nn_graph_t* graph,
+    vsi_nn_graph_attr_preload_type_e attr,
+    uint32_t size
+    )
+{
+    vsi_status status;
+    status = VSI_FAILURE;
+
+#if(defined(VX_PRELOAD_CONST_TENSOR_SUPPORT) && VX_PRELOAD_CONST_TENSOR_SUPPORT)
+    if(graph && graph->g)
+    {
+        switch(attr)
+        {
+            case VSI_NN_GRAPH_PRELOAD_VIPSRAM:
+            {
+                status = vxSetGraphAttribute(graph->g, VX_GRAPH_VIP_SRAM_PRE_LOAD, &size, sizeof(size));
+                break;
+            }
+
+            case VSI_NN_GRAPH_PRELOAD_AXISRAM:
+            {
+                status = vxSetGraphAttribute(graph->g, VX_GRAPH_AXI_SRAM_PRE_LOAD, &size, sizeof(size));
+                break;
+            }
+
+            default:
+            {
+                VSILOGE("Unsupported graph attribute: %d", attr);
+                break;
+            }
+        }
+    }
+#else
+    status = VSI_SUCCESS;
+#endif
+
+    return status;
+}
+
+vsi_nn_tensor_id_t vsi_nn_get_tensor_id
+    (
+    vsi_nn_graph_t* graph,
+    const vsi_nn_tensor_t * tensor
+    )
+{
+    uint32_t i;
+    vsi_nn_tensor_t * iter;
+    if( !graph || !tensor )
+    {
+        return VSI_NN_TENSOR_ID_NA;
+    }
+    if( tensor->graph == graph && vsi_nn_GetTensor( graph, tensor->id ) == tensor )
+    {
+        return tensor->id;
     }
     for(i = 0; i < graph->tensor_num; i++)
     {
@@ -22,12 +22,14 @@
 *
 *****************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 
 #include "vsi_nn_graph_optimization.h"
 #include "vsi_nn_tensor_util.h"
 #include "vsi_nn_graph.h"
 #include "vsi_nn_log.h"
 #include "vsi_nn_test.h"
+#include "utils/vsi_nn_dtype_util.h"
 
 
 static vsi_bool _is_asymm_int8_norm_tensor
@@ -95,13 +97,13 @@ static vsi_status _add_forward_node
         {
             if(first_node[i]->input.tensors[j] == input)
             {
-                first_node[i]->input.tensors[j] = output;
+                vsi_nn_SetNodeInput( first_node[i], j, output );
             }
         }
     }
 
-    node->input.tensors[0] = input;
-    node->output.tensors[0] = output;
+    vsi_nn_SetNodeInput( node, 0, input );
+    vsi_nn_SetNodeOutput( node, 0, output );
 
     return VSI_SUCCESS;
 }/* _add_forward_node() */
@@ -122,13 +124,13 @@ static vsi_status _add_backward_node
     {
         if(last_node->output.tensors[i] == output)
         {
-            last_node->output.tensors[i] = input;
+            vsi_nn_SetNodeOutput( last_node, i, input );
             break;
         }
     }
 
-    node->input.tensors[0] = input;
-    node->output.tensors[0] = output;
+    vsi_nn_SetNodeInput( node, 0, input );
+    vsi_nn_SetNodeOutput( node, 0, output );
 
     return VSI_SUCCESS;
 }/* _add_backward_node() */
@@ -885,3 +887,189 @@ vsi_status vsi_nn_OptimizeGraph
 final:
     return status;
 } /* vsi_nn_OptimizeGraph() */
+
+static vsi_bool _is_inplace_op
+    (
+    vsi_nn_op_t op
+    )
+{
+    switch( op )
+    {
+    case VSI_NN_OP_ADD:
+    case VSI_NN_OP_MULTIPLY:
+    case VSI_NN_OP_DATACONVERT:
+    case VSI_NN_OP_RELU:
+    case VSI_NN_OP_RELU1:
+    case VSI_NN_OP_RELU6:
+    case VSI_NN_OP_RELUN:
+    case VSI_NN_OP_LEAKY_RELU:
+    case VSI_NN_OP_SIGMOID:
+    case VSI_NN_OP_TANH:
+    case VSI_NN_OP_SWISH:
+    case VSI_NN_OP_SOFTRELU:
+    case VSI_NN_OP_CLIP:
+    case VSI_NN_OP_LINEAR:
+    case VSI_NN_OP_ABS:
+    case VSI_NN_OP_SQRT:
+    case VSI_NN_OP_RSQRT:
+    case VSI_NN_OP_SQUARE:
+    /* eltwise_unary kernels */
+    case VSI_NN_OP_SIN:
+    case VSI_NN_OP_COS:
+    case VSI_NN_OP_EXP:
+    case VSI_NN_OP_LOG:
+    case VSI_NN_OP_ELU:
+    case VSI_NN_OP_NEG:
+    case VSI_NN_OP_HARD_SIGMOID:
+    case VSI_NN_OP_MISH:
+    case VSI_NN_OP_ROUND:
+    case VSI_NN_OP_GELU:
+    case VSI_NN_OP_SELU:
+    case VSI_NN_OP_CELU:
+    case VSI_NN_OP_RCP:
+    case VSI_NN_OP_SIGN:
+    case VSI_NN_OP_SOFTSIGN:
+        return TRUE;
+    default:
+        return FALSE;
+    }
+} /* _is_inplace_op() */
+
+static vsi_bool _is_graph_output
+    (
+    vsi_nn_graph_t* graph,
+    vsi_nn_tensor_id_t id
+    )
+{
+    uint32_t i;
+
+    for( i = 0; i < graph->output.num; i++ )
+    {
+        if( graph->output.tensors[i] == id )
+        {
+            return TRUE;
+        }
+    }
+    return FALSE;
+} /* _is_graph_output() */
+
+static vsi_bool _is_inplace_tensor
+    (
+    vsi_nn_graph_t* graph,
+    vsi_nn_tensor_id_t id,
+    vsi_nn_tensor_t* tensor
+    )
+{
+    return ( NULL != tensor && tensor->attr.vtl && !tensor->attr.is_const
+        && !_is_graph_output( graph, id ) );
+} /* _is_inplace_tensor() */
+
+vsi_status vsi_nn_InplaceOptimizeGraph
+    (
+    vsi_nn_graph_t* graph,
+    const vsi_nn_node_id_t* node_list
+    )
+{
+    uint32_t i, j;
+    uint32_t count = 0;
+    uint32_t consumer_num;
+    vsi_nn_tensor_id_t* source;
+    vsi_nn_node_t* node;
+    vsi_nn_tensor_id_t input_id;
+    vsi_nn_tensor_id_t output_id;
+    vsi_nn_tensor_t* input;
+    vsi_nn_tensor_t* output;
+
+    if( NULL == graph || NULL == node_list )
+    {
+        return VSI_FAILURE;
+    }
+    /*
+     * Outputs made views of their input by this pass, they may be written
+     * over again. Kept on the graph for the memory plan and later setups.
+     */
+    if( graph->inplace_source_num < graph->tensor_num + 1 )
+    {
+        source = (vsi_nn_tensor_id_t *)realloc( graph->inplace_source,
+            ( graph->tensor_num + 1 ) * sizeof( vsi_nn_tensor_id_t ) );
+        if( NULL == source )
+        {
+            return VSI_FAILURE;
+        }
+        for( i = graph->inplace_source_num; i < graph->tensor_num + 1; i++ )
+        {
+            source[i] = VSI_NN_TENSOR_ID_NA;
+        }
+        graph->inplace_source = source;
+        graph->inplace_source_num = graph->tensor_num + 1;
+    }
+    source = graph->inplace_source;
+
+    for( i = 0; i < graph->node_num; i++ )
+    {
+        node = vsi_nn_GetNode( graph, node_list[i] );
+        if( NULL == node || !_is_inplace_op( node->op ) || 1 != node->output.num )
+        {
+            continue;
+        }
+        output_id = node->output.tensors[0];
+        output = vsi_nn_GetTensor( graph, output_id );
+        if( !_is_inplace_tensor( graph, output_id, output ) || NULL != output->t )
+        {
+            continue;
+        }
+
+        for( j = 0; j < node->input.num; j++ )
+        {
+            input_id = node->input.tensors[j];
+            input = vsi_nn_GetTensor( graph, input_id );
+            if( !_is_inplace_tensor( graph, input_id, input ) )
+            {
+                continue;
+            }
+            /*
+             * A vx tensor created before compute is a view shared with other
+             * tensors, unless it is one of ours, so writing over it is unsafe.
+             */
+            if( NULL != input->t && VSI_NN_TENSOR_ID_NA == source[input_id] )
+            {
+                continue;
+            }
+            consumer_num = 0;
+            vsi_nn_get_tensor_consumers( graph, input_id, NULL, &consumer_num );
+            if( 1 != consumer_num
+             || input->attr.dim_num != output->attr.dim_num
+             || memcmp( input->attr.size, output->attr.size,
+                    input->attr.dim_num * sizeof( input->attr.size[0] ) ) != 0
+             || !vsi_nn_DtypeCompare( &input->attr.dtype, &output->attr.dtype ) )
+            {
+                continue;
+            }
+
+            if( NULL == input->t && !vsi_nn_TensorReinit( graph, input ) )
+            {
+                continue;
+            }
+            output->t = vsi_nn_safe_reshape_tensor( input->t,
+                (void*)output->attr.size, (vsi_size_t)output->attr.dim_num,
+                sizeof( output->attr.size[0] ) );
+            if( NULL == output->t )
+            {
+                VSILOGW( "Create inplace output of node[%u] %s fail",
+                    node->id, vsi_nn_OpGetName( node->op ) );
+                break;
+            }
+            VSILOGD( "Node[%u] %s writes over tensor[%u]",
+                node->id, vsi_nn_OpGetName( node->op ), input_id );
+            source[output_id] = input_id;
+            count ++;
+            break;
+        }
+    }
+
+    if( count > 0 )
+    {
+        VSILOGI( "Run %u nodes inplace", count );
+    }
+    return VSI_SUCCESS;
+} /* vsi_nn_InplaceOptimizeGraph() */
@@ -29,9 +29,11 @@
 #include "vsi_nn_log.h"
 #include "vsi_nn_node.h"
 #include "vsi_nn_graph.h"
+#include "vsi_nn_internal_node.h"
 #include "vsi_nn_ops.h"
 #include "vsi_nn_tensor.h"
 #include "vsi_nn_types.h"
+#include "utils/vsi_nn_math.h"
 #include "utils/vsi_nn_util.h"
 
 vsi_nn_node_t * vsi_nn_NewNode
@@ -89,6 +91,7 @@ vsi_nn_node_t * vsi_nn_NewNode
     }
 
     node->uid = VSI_NN_NODE_UID_NA;
+    node->id = VSI_NN_NODE_ID_NA;
     return node;
 } /* vsi_nn_NewNode() */
 
@@ -149,7 +152,7 @@ vsi_status vsi_nn_SetNodeInputsAndOutputs
         for(i = 0; i < input_num; i ++)
         {
             id = vsi_nn_get_tensor_id(node->graph, inputs[i]);
-            node->input.tensors[i] = id;
+            vsi_nn_SetNodeInput( node, (uint32_t)i, id );
         }
     }
     if( outputs && output_num > 0 )
@@ -158,7 +161,7 @@ vsi_status vsi_nn_SetNodeInputsAndOutputs
         for(i = 0; i < output_num; i ++)
         {
             id = vsi_nn_get_tensor_id(node->graph, outputs[i]);
-            node->output.tensors[i] = id;
+            vsi_nn_SetNodeOutput( node, (uint32_t)i, id );
         }
     }
     return status;
@@ -247,3 +250,46 @@ vsi_status vsi_nn_update_node_attr
 
     return status;
 } /* vsi_nn_update_node_attr() */
+
+vsi_status vsi_nn_GetNodePerf
+    (
+    vsi_nn_node_t * node,
+    vx_perf_t * perf
+    )
+{
+    vsi_status status = VSI_SUCCESS;
+    vsi_nn_internal_node_t * curr = NULL;
+    vx_perf_t node_perf;
+
+    if( NULL == node || NULL == perf )
+    {
+        return VSI_FAILURE;
+    }
+    memset( perf, 0, sizeof( vx_perf_t ) );
+
+    if( NULL != node->n )
+    {
+        status = vxQueryNode( node->n, VX_NODE_PERFORMANCE,
+            perf, sizeof( vx_perf_t ) );
+    }
+    else if( NULL != node->internal_node_wksp )
+    {
+        curr = ((vsi_nn_internal_node_wksp_t *)node->internal_node_wksp)->nodes;
+        while( NULL != curr && VSI_SUCCESS == status )
+        {
+            status = vsi_nn_GetNodePerf( curr->node, &node_perf );
+            if( VSI_SUCCESS == status && node_perf.tmp > 0 )
+            {
+                if( 0 == perf->beg || node_perf.beg < perf->beg )
+                {
+                    perf->beg = node_perf.beg;
+                }
+                perf->end = vsi_nn_max( perf->end, node_perf.end );
+                perf->tmp += node_perf.tmp;
+            }
+            curr = (vsi_nn_internal_node_t *)vsi_nn_LinkListNext( (vsi_nn_link_list_t *)curr );
+        }
+    }
+
+    return status;
+} /* vsi_nn_GetNodePerf() */
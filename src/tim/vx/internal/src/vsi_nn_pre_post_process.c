@@ -570,7 +570,7 @@ vsi_status vsi_nn_add_single_preproc_node
         {
             if(first_node[i]->input.tensors[j] == org_input)
             {
-                first_node[i]->input.tensors[j] = preproc_output;
+                vsi_nn_SetNodeInput( first_node[i], j, preproc_output );
                 break;
             }
         }
@@ -578,11 +578,11 @@ vsi_status vsi_nn_add_single_preproc_node
 
     for(i = 0; i < node_input_num; i++)
     {
-        node->input.tensors[i] = preproc_inputs[i];
+        vsi_nn_SetNodeInput( node, i, preproc_inputs[i] );
     }
     _reconnect_graph_inputs(graph, org_input, input_idx, preproc_inputs, node_input_num);
 
-    node->output.tensors[0] = preproc_output;
+    vsi_nn_SetNodeOutput( node, 0, preproc_output );
 
     status = VSI_SUCCESS;
 
@@ -671,7 +671,7 @@ vsi_status vsi_nn_add_single_postproc_node
                     {
                         if(consume_nodes[i]->input.tensors[j] == graph->output.tensors[output_idx])
                         {
-                            consume_nodes[i]->input.tensors[j] = postproc_input;
+                            vsi_nn_SetNodeInput( consume_nodes[i], j, postproc_input );
                             break;
                         }
                     }
@@ -679,13 +679,13 @@ vsi_status vsi_nn_add_single_postproc_node
     }
 
     /* Reconnect node tensors */
-    node->input.tensors[0] = postproc_input;
-    node->output.tensors[0] = postproc_output;
+    vsi_nn_SetNodeInput( node, 0, postproc_input );
+    vsi_nn_SetNodeOutput( node, 0, postproc_output );
     for(i = 0; i < last_node->output.num; i++)
     {
         if(last_node->output.tensors[i] == graph->output.tensors[output_idx])
         {
-            last_node->output.tensors[i] = postproc_input;
+            vsi_nn_SetNodeOutput( last_node, i, postproc_input );
             break;
         }
     }
@@ -715,6 +715,7 @@ vsi_status vsi_nn_AddGraphPreProcess
     vsi_nn_node_t** nodes = NULL;
     vsi_nn_tensor_id_t* graph_inputs=NULL;
 
+    vsi_nn_RefreshTensorAdjacency(graph);
     graph_inputs = (vsi_nn_tensor_id_t*)malloc(sizeof(vsi_nn_tensor_id_t)*graph->input.num);
     TEST_CHECK_PTR( graph_inputs, final );
     _get_org_graph_inputs(graph, graph_inputs);
@@ -754,6 +755,7 @@ vsi_status vsi_nn_AddGraphPostProcess
     vsi_nn_tensor_id_t output;
     vsi_nn_node_t * node = NULL;
 
+    vsi_nn_RefreshTensorAdjacency(graph);
     output = graph->output.tensors[output_idx];
     vsi_nn_get_tensor_provider(graph, output, &node);
     if(node != NULL)
@@ -790,6 +792,8 @@ vsi_status vsi_nn_AddBinaryGraphInputsWithCropParam
     num_of_graph_real_inputs = 0;
     num_of_graph_real_outputs = 0;
 
+    vsi_nn_RefreshTensorAdjacency(graph);
+
     /* Explicitly set graph inputs and outputs */
     num_of_graph_inputs = graph->input.num;
     processed_node_id_list = (vsi_nn_node_id_t*)malloc(num_of_graph_inputs * sizeof(vsi_nn_node_id_t));
@@ -2206,6 +2206,19 @@ vsi_nn_tensor_rel_t *vsi_nn_CreateTensorRelevance
     return tensor_ref;
 } /* vsi_nn_CreateTensorRelevance() */
 
+static void _mark_tensor_swapped
+    (
+    vsi_nn_tensor_t * tensor
+    )
+{
+    /* Only queue the tensor once until the graph rebinds it */
+    if( !tensor->is_swapped && NULL != tensor->graph )
+    {
+        vsi_nn_MarkTensorSwapped( tensor->graph, tensor->id );
+    }
+    tensor->is_swapped = TRUE;
+} /* _mark_tensor_swapped() */
+
 vsi_status vsi_nn_SwapTensorHandle
     (
     vsi_nn_tensor_t * tensor0,
@@ -2240,8 +2253,8 @@ vsi_status vsi_nn_SwapTensorHandle
     status = vxSwapTensor( tensor0->t, tensor1->t );
     if( VX_SUCCESS == status )
     {
-        tensor0->is_swapped = TRUE;
-        tensor1->is_swapped = TRUE;
+        _mark_tensor_swapped( tensor0 );
+        _mark_tensor_swapped( tensor1 );
     }
 
     return status;
@@ -40,8 +40,8 @@ class OpImpl {
   virtual ~OpImpl() = default;
   virtual OpImpl& BindInput(const std::shared_ptr<Tensor>& tensor) = 0;
   virtual OpImpl& BindOutput(const std::shared_ptr<Tensor>& tensor) = 0;
-  virtual std::vector<std::shared_ptr<Tensor>> InputsTensor() = 0;
-  virtual std::vector<std::shared_ptr<Tensor>> OutputsTensor() = 0;
+  virtual const std::vector<std::shared_ptr<Tensor>>& InputsTensor() = 0;
+  virtual const std::vector<std::shared_ptr<Tensor>>& OutputsTensor() = 0;
   virtual vsi_nn_node_t* node() = 0;
   virtual void SetRoundingPolicy(
       OverflowPolicy overflow_policy = OverflowPolicy::SATURATE,
@@ -41,14 +41,14 @@ const std::unique_ptr<OpImpl>& Operation::impl() const { return impl_; }
 
 Operation& Operation::BindInput(const std::shared_ptr<Tensor>& tensor) {
   impl_->BindInput(tensor);
-  impl_->graph_->UpdateTensorConsumersMap(tensor, this);
+  impl_->graph_->UpdateTensorConsumersMap(tensor, shared_from_this());
   OnBindInputPostProc(tensor, impl_->input_tensor_index - 1);
   return *this;
 }
 
 Operation& Operation::BindOutput(const std::shared_ptr<Tensor>& tensor) {
   impl_->BindOutput(tensor);
-  impl_->graph_->UpdateTensorProducerMap(tensor, this);
+  impl_->graph_->UpdateTensorProducerMap(tensor, shared_from_this());
   return *this;
 }
 
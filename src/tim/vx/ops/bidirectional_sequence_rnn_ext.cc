@@ -244,10 +244,10 @@ class BidirectionalSequenceRnnExtImpl : public OpImpl {
 
   vsi_nn_node_t* node() override { return nullptr; }
 
-  std::vector<std::shared_ptr<Tensor>> InputsTensor() override {
+  const std::vector<std::shared_ptr<Tensor>>& InputsTensor() override {
     return inputs_tensor_;
   }
-  std::vector<std::shared_ptr<Tensor>> OutputsTensor() override {
+  const std::vector<std::shared_ptr<Tensor>>& OutputsTensor() override {
     return outputs_tensor_;
   }
 
@@ -0,0 +1,149 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "param_utils.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace tim {
+namespace vx {
+
+namespace {
+
+// Bytes of nn_param that op_init fills with state of its own, such as
+// pointers to local data. They are found by comparing two fresh nodes of
+// the op, a whole pointer sized word at a time since two allocations can
+// share their upper address bytes.
+const std::vector<bool>& InitStateMask(vsi_nn_context_t ctx, vsi_nn_op_t op) {
+  static std::mutex mutex;
+  static std::unordered_map<vsi_nn_op_t, std::vector<bool>> masks;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = masks.find(op);
+  if (it != masks.end()) {
+    return it->second;
+  }
+  std::vector<bool> mask(sizeof(vsi_nn_nn_param_t), false);
+  vsi_nn_graph_t* probe = vsi_nn_CreateGraph(ctx, 0, 2);
+  if (probe) {
+    vsi_nn_node_t* a = vsi_nn_AddNode(probe, op, 0, 0, NULL);
+    vsi_nn_node_t* b = vsi_nn_AddNode(probe, op, 0, 0, NULL);
+    if (a && b) {
+      auto pa = reinterpret_cast<const uint8_t*>(&a->nn_param);
+      auto pb = reinterpret_cast<const uint8_t*>(&b->nn_param);
+      const size_t word = sizeof(void*);
+      for (size_t i = 0; i < mask.size(); i += word) {
+        size_t n = std::min(word, mask.size() - i);
+        if (0 != memcmp(pa + i, pb + i, n)) {
+          std::fill(mask.begin() + i, mask.begin() + i + n, true);
+        }
+      }
+    }
+    vsi_nn_ReleaseGraph(&probe);
+  }
+  return masks.emplace(op, std::move(mask)).first->second;
+}
+
+}  // namespace
+
+#define PARAM_ARRAY(param, field, count)                                \
+  ParamArray {                                                          \
+    offsetof(vsi_nn_nn_param_t, param.field),                           \
+        node->nn_param.param.field,                                     \
+        node->nn_param.param.field                                      \
+            ? sizeof(*node->nn_param.param.field) * node->nn_param.param.count \
+            : 0                                                         \
+  }
+
+std::vector<ParamArray> ParamArrays(const vsi_nn_node_t* node) {
+  switch (node->op) {
+    case VSI_NN_OP_PERMUTE:
+      return {PARAM_ARRAY(permute, perm, dim_num)};
+#ifdef _VSI_NN_OP_RESHAPE2_H
+    case VSI_NN_OP_RESHAPE2:
+      return {PARAM_ARRAY(reshape2, size, dim_num)};
+#else
+    case VSI_NN_OP_RESHAPE:
+      return {PARAM_ARRAY(reshape, size, dim_num)};
+#endif
+    case VSI_NN_OP_SQUEEZE:
+      return {PARAM_ARRAY(squeeze, axis, axis_num)};
+    case VSI_NN_OP_PAD:
+      return {PARAM_ARRAY(pad, front_size, dim_num),
+              PARAM_ARRAY(pad, back_size, dim_num)};
+    case VSI_NN_OP_PAD2:
+      return {PARAM_ARRAY(pad2, front_size, dim_num),
+              PARAM_ARRAY(pad2, back_size, dim_num)};
+    case VSI_NN_OP_BATCH2SPACE:
+      return {PARAM_ARRAY(batch2space, block_size, block_size_num)};
+    case VSI_NN_OP_SPACE2BATCH:
+      return {PARAM_ARRAY(space2batch, block_size, block_size_num)};
+    case VSI_NN_OP_EXPAND_BROADCAST:
+      return {PARAM_ARRAY(expand_broadcast, shape, dim_num),
+              PARAM_ARRAY(expand_broadcast, dimensions, dimensions_num)};
+    case VSI_NN_OP_MOMENTS:
+      return {PARAM_ARRAY(moments, axis, axis_num)};
+    case VSI_NN_OP_REDUCE:
+      return {PARAM_ARRAY(reduce, axis, axis_num)};
+    case VSI_NN_OP_REVERSE:
+      return {PARAM_ARRAY(reverse, axis, axis_num)};
+    case VSI_NN_OP_SCATTER_ND:
+      return {PARAM_ARRAY(scatter_nd, shape, dim_num)};
+    case VSI_NN_OP_SLICE:
+      return {PARAM_ARRAY(slice, start, dims),
+              PARAM_ARRAY(slice, length, dims)};
+    case VSI_NN_OP_STRIDED_SLICE:
+      return {PARAM_ARRAY(strided_slice, begin_dims, begin_dims_num),
+              PARAM_ARRAY(strided_slice, end_dims, end_dims_num),
+              PARAM_ARRAY(strided_slice, stride_dims, stride_dims_num)};
+    case VSI_NN_OP_SPLIT:
+      return {PARAM_ARRAY(split, slices, slices_num)};
+    case VSI_NN_OP_TILE:
+      return {PARAM_ARRAY(tile, multiples, multiples_num)};
+    default:
+      return {};
+  }
+}
+
+#undef PARAM_ARRAY
+
+vsi_nn_nn_param_t ComparableParam(const vsi_nn_node_t* node) {
+  vsi_nn_nn_param_t param = node->nn_param;
+  auto bytes = reinterpret_cast<uint8_t*>(&param);
+  const auto& mask = InitStateMask(node->graph->ctx, node->op);
+  for (size_t i = 0; i < mask.size(); ++i) {
+    if (mask[i]) {
+      bytes[i] = 0;
+    }
+  }
+  for (const auto& array : ParamArrays(node)) {
+    memset(bytes + array.offset, 0, sizeof(void*));
+  }
+  return param;
+}
+
+}  // namespace vx
+}  // namespace tim
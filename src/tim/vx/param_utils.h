@@ -0,0 +1,54 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_PARAM_UTILS_H_
+#define TIM_VX_PARAM_UTILS_H_
+
+#include <cstddef>
+#include <vector>
+
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+/// A parameter array an op points nn_param at
+struct ParamArray {
+  size_t offset;  // of the pointer inside nn_param
+  const void* data;
+  size_t bytes;
+};
+
+/// The arrays behind the pointers tim-vx ops set in nn_param
+std::vector<ParamArray> ParamArrays(const vsi_nn_node_t* node);
+
+/// Copy of the node's nn_param that compares equal for nodes built with
+/// the same parameters: the pointers listed by ParamArrays() and the state
+/// op_init allocates for every node, like reshape2.local, are zeroed.
+/// Pointers set by other ops are kept.
+vsi_nn_nn_param_t ComparableParam(const vsi_nn_node_t* node);
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_PARAM_UTILS_H_ */
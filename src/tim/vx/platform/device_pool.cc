@@ -0,0 +1,194 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/vx/platform/device_pool.h"
+
+namespace tim {
+namespace vx {
+namespace platform {
+
+std::shared_ptr<DevicePool> DevicePool::Create(
+    const std::vector<std::shared_ptr<IDevice>>& devices) {
+  return std::shared_ptr<DevicePool>(new DevicePool(devices));
+}
+
+DevicePool::DevicePool(const std::vector<std::shared_ptr<IDevice>>& devices)
+    : slots_(devices.size()) {
+  for (size_t i = 0; i < devices.size(); i++) {
+    slots_[i].executor = std::make_shared<NativeExecutor>(devices[i]);
+  }
+}
+
+DevicePool::model_id_t DevicePool::AddModel(const GraphBuilder& builder) {
+  std::lock_guard<std::mutex> lock(mtx_);
+  for (auto& slot : slots_) {
+    auto graph = builder(slot.executor->Contex());
+    Model model;
+    model.executable = slot.executor->Compile(graph);
+    for (auto& tensor : graph->InputsTensor()) {
+      auto handle = model.executable->AllocateTensor(tensor->GetSpec());
+      model.executable->SetInput(handle);
+      model.inputs.push_back(handle);
+      model.input_bytes.push_back(
+          static_cast<uint32_t>(tensor->GetSpec().GetByteSize()));
+    }
+    for (auto& tensor : graph->OutputsTensor()) {
+      auto handle = model.executable->AllocateTensor(tensor->GetSpec());
+      model.executable->SetOutput(handle);
+      model.outputs.push_back(handle);
+    }
+    if (!model.executable->Verify()) {
+      std::cout << "Compile model for device " << slot.executor->Device()->Id()
+                << " failed" << std::endl;
+    }
+    slot.models.push_back(model);
+  }
+  return model_count_++;
+}
+
+bool DevicePool::Dispatch(const Request& request) {
+  size_t device = 0;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (slots_.empty() || request.model >= model_count_) {
+      return false;
+    }
+    size_t least = static_cast<size_t>(-1);
+    for (size_t i = 0; i < slots_.size(); i++) {
+      size_t load = slots_[i].queue.size() + (slots_[i].busy ? 1 : 0);
+      if (load < least) {
+        least = load;
+        device = i;
+      }
+    }
+    completion_.Begin();
+    if (slots_[device].busy) {
+      slots_[device].queue.push_back(request);
+      return true;
+    }
+    slots_[device].busy = true;
+  }
+  Start(device, request);
+  return true;
+}
+
+void DevicePool::Start(size_t device, const Request& request) {
+  Model* model_ptr = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    model_ptr = &slots_[device].models[request.model];
+  }
+  Model& model = *model_ptr;
+  bool status = request.inputs.size() == model.inputs.size() &&
+                request.outputs.size() == model.outputs.size();
+  for (size_t i = 0; status && i < model.inputs.size(); i++) {
+    status = model.inputs[i]->CopyDataToTensor(request.inputs[i],
+                                               model.input_bytes[i]);
+  }
+  if (!status) {
+    Finish(device, request, false);
+    return;
+  }
+  auto self = shared_from_this();
+  auto done = [self, device, request, model_ptr](const void*) {
+    bool status = true;
+    for (size_t i = 0; i < model_ptr->outputs.size(); i++) {
+      status =
+          model_ptr->outputs[i]->CopyDataFromTensor(request.outputs[i]) &&
+          status;
+    }
+    self->Finish(device, request, status);
+    return status;
+  };
+  // Called from done for queued requests, Launch does not wait for room in
+  // the device queue there.
+  if (!model.executable->Launch(done)) {
+    Finish(device, request, false);
+  }
+}
+
+void DevicePool::Finish(size_t device, const Request& request, bool status) {
+  if (request.done) {
+    request.done(status);
+  }
+  Request next;
+  bool has_next = false;
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    slots_[device].completed++;
+    has_next = Next(device, next);
+    if (!has_next) {
+      slots_[device].busy = false;
+    }
+  }
+  completion_.Finish();
+  if (has_next) {
+    Start(device, next);
+  }
+}
+
+bool DevicePool::Next(size_t device, Request& request) {
+  auto& own = slots_[device].queue;
+  if (!own.empty()) {
+    request = own.front();
+    own.pop_front();
+    return true;
+  }
+  // Steal the newest request of the longest queue, its owner is the
+  // furthest from reaching it.
+  size_t victim = device;
+  size_t longest = 0;
+  for (size_t i = 0; i < slots_.size(); i++) {
+    if (slots_[i].queue.size() > longest) {
+      longest = slots_[i].queue.size();
+      victim = i;
+    }
+  }
+  if (0 == longest) {
+    return false;
+  }
+  request = slots_[victim].queue.back();
+  slots_[victim].queue.pop_back();
+  return true;
+}
+
+void DevicePool::Wait() {
+  completion_.Wait();
+}
+
+size_t DevicePool::DeviceCount() const {
+  return slots_.size();
+}
+
+std::vector<size_t> DevicePool::CompletedPerDevice() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  std::vector<size_t> completed;
+  for (auto& slot : slots_) {
+    completed.push_back(slot.completed);
+  }
+  return completed;
+}
+
+}  // namespace platform
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,89 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/vx/platform/device_pool.h"
+#include "tim/vx/ops/elementwise.h"
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+std::shared_ptr<tim::vx::Graph> BuildScale(const std::shared_ptr<tim::vx::Context>& ctx) {
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto graph = ctx->CreateGraph();
+  auto in = graph->CreateTensor(input_spec);
+  auto out = graph->CreateTensor(output_spec);
+  graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({in, in}).BindOutput(out);
+  return graph;
+}
+
+}  // namespace
+
+TEST(device_pool, runs_every_request) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  ASSERT_FALSE(devices.empty());
+  auto pool = tim::vx::platform::DevicePool::Create(devices);
+  auto model = pool->AddModel(BuildScale);
+
+  const size_t kRequests = 16;
+  std::vector<std::vector<float>> inputs, outputs;
+  for (size_t i = 0; i < kRequests; i++) {
+    float v = static_cast<float>(i);
+    inputs.push_back({v, v + 1, v + 2, v + 3});
+    outputs.push_back(std::vector<float>(4, 0.0f));
+  }
+  std::atomic<size_t> succeeded(0);
+  for (size_t i = 0; i < kRequests; i++) {
+    EXPECT_TRUE(pool->Dispatch({model, {inputs[i].data()}, {outputs[i].data()},
+                                [&succeeded](bool ok) {
+                                  if (ok) succeeded++;
+                                }}));
+  }
+  pool->Wait();
+
+  EXPECT_EQ(kRequests, succeeded.load());
+  for (size_t i = 0; i < kRequests; i++) {
+    for (size_t j = 0; j < 4; j++) {
+      EXPECT_FLOAT_EQ(2 * inputs[i][j], outputs[i][j]);
+    }
+  }
+  size_t completed = 0;
+  for (auto count : pool->CompletedPerDevice()) {
+    completed += count;
+  }
+  EXPECT_EQ(kRequests, completed);
+}
+
+TEST(device_pool, rejects_unknown_model) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  auto pool = tim::vx::platform::DevicePool::Create(devices);
+  float in = 0, out = 0;
+  EXPECT_FALSE(pool->Dispatch({0, {&in}, {&out}, nullptr}));
+}
@@ -24,6 +24,9 @@
 #include "tim/vx/platform/native.h"
 #include "native_device_private.h"
 
+#include <algorithm>
+#include <thread>
+
 namespace tim {
 namespace vx {
 namespace platform {
@@ -38,33 +41,102 @@ std::shared_ptr<IExecutable> CreateExecutableSet(const std::vector<std::shared_p
   return executable;
 }
 
+void Completion::Begin() {
+  std::lock_guard<std::mutex> lock(mtx_);
+  pending_++;
+}
+
+void Completion::Finish() {
+  {
+    std::lock_guard<std::mutex> lock(mtx_);
+    pending_--;
+  }
+  cv_.notify_all();
+}
+
+void Completion::Wait() {
+  std::unique_lock<std::mutex> lock(mtx_);
+  cv_.wait(lock, [this]() { return 0 == pending_; });
+}
+
 IDevice::device_id_t IDevice::Id() const {
   return device_id_;
 }
 
-NativeDeviceImpl::NativeDeviceImpl(device_id_t id) {
-  vip_device_ = std::make_unique<vip::IDevice> (id);
+NativeDeviceImpl::NativeDeviceImpl(device_id_t id, uint32_t worker_count, uint64_t cpu_mask) {
+  vip_device_ = std::make_unique<vip::IDevice> (id, vip::kDefaultQueueCapacity, worker_count, cpu_mask);
   device_id_ = id;
 }
 
 bool NativeDeviceImpl::Submit(const std::shared_ptr<Graph>& graph) {
   GraphImpl* graphimp = dynamic_cast<GraphImpl*> (graph.get()); // hack to downcast
+  std::lock_guard<std::mutex> lock(graph_mtx_);
   vsi_graph_v_.push_back(graphimp->graph());
   return true;
 }
 
 bool NativeDeviceImpl::Trigger(bool async, async_callback cb) {
 // extract graph from tasks
-  (void)async;
   bool status = false;
-  while (!vsi_graph_v_.empty()) {
-    auto task = vsi_graph_v_.front();
-    vsi_graph_v_.erase(vsi_graph_v_.begin());
-    status = vip_device_->GraphSubmit(task, cb, NULL);
+  {
+    std::lock_guard<std::mutex> lock(graph_mtx_);
+    for (auto task : vsi_graph_v_) {
+      status = Queue(task, cb);
+    }
+    vsi_graph_v_.clear();
+  }
+  if (!async) {
+    WaitDeviceIdle();
   }
   return status;
 }
 
+bool NativeDeviceImpl::Enqueue(const std::shared_ptr<Graph>& graph, async_callback cb) {
+  GraphImpl* graphimp = dynamic_cast<GraphImpl*> (graph.get()); // hack to downcast
+  return Queue(graphimp->graph(), cb);
+}
+
+// Set while a device worker runs a callback queued by NativeDeviceImpl
+static thread_local bool in_device_callback = false;
+
+bool NativeDeviceImpl::Queue(vsi_nn_graph_t* graph, const async_callback& cb) {
+  vip::func_t func = [this, cb](const void* data) {
+    bool status = true;
+    if (cb) {
+      bool outer = in_device_callback;
+      in_device_callback = true;
+      status = cb(data);
+      in_device_callback = outer;
+    }
+    // A slot was freed for this graph, pass it on to the parked ones. Runs
+    // before the vip device counts this graph as done, so the device does
+    // not look idle while graphs are parked.
+    DrainPending();
+    return status;
+  };
+  if (!in_device_callback) {
+    return vip_device_->GraphSubmit(graph, func, NULL);
+  }
+  // Parked graphs stay in order and are only picked up by a later callback,
+  // which holds pending_mtx_ while it drains, so once the queue is seen full
+  // here some queued graph is still to finish and drain this one.
+  std::lock_guard<std::mutex> lock(pending_mtx_);
+  if (pending_.empty() && vip_device_->TryGraphSubmit(graph, func, NULL)) {
+    return true;
+  }
+  pending_.emplace_back(graph, func);
+  return true;
+}
+
+void NativeDeviceImpl::DrainPending() {
+  std::lock_guard<std::mutex> lock(pending_mtx_);
+  while (!pending_.empty() &&
+         vip_device_->TryGraphSubmit(pending_.front().first,
+                                     pending_.front().second, NULL)) {
+    pending_.pop_front();
+  }
+}
+
 void NativeDeviceImpl::WaitDeviceIdle() {
   vip_device_->WaitThreadIdle();
 }
@@ -73,15 +145,24 @@ bool NativeDeviceImpl::DeviceExit() {
   return vip_device_->ThreadExit();
 }
 
-std::vector<std::shared_ptr<IDevice>> NativeDevice::Enumerate() {
+std::vector<std::shared_ptr<IDevice>> NativeDevice::Enumerate(const NativeDeviceOptions& options) {
   std::vector<std::shared_ptr<IDevice>> device_v;
   device_id_t deviceCount = 0;
   vsi_nn_context_t context;
   context = vsi_nn_CreateContext();
   vxQueryContext(context->c, VX_CONTEXT_DEVICE_COUNT_VIV, &deviceCount, sizeof(deviceCount));
   std::cout<< "Device count = "<< deviceCount <<std::endl;
+  uint32_t worker_count = options.worker_count;
+  if (0 == worker_count && deviceCount > 0) {
+    uint32_t cores = std::thread::hardware_concurrency();
+    if (0 == cores) {
+      worker_count = vip::kDefaultWorkerCount;
+    } else {
+      worker_count = std::max(1u, std::min(vip::kDefaultWorkerCount, cores / deviceCount));
+    }
+  }
   for (device_id_t i = 0; i < deviceCount; i++) {
-    IDevice* local_device = new NativeDeviceImpl(i);
+    IDevice* local_device = new NativeDeviceImpl(i, worker_count, options.cpu_mask);
     std::shared_ptr<IDevice> local_device_sp(local_device);
     device_v.push_back(local_device_sp);
   }
@@ -101,6 +182,22 @@ std::shared_ptr<IExecutor> IExecutable::Executor() const {
   return executor;
 }
 
+bool IExecutable::Launch(const IDevice::async_callback& done) {
+  bool status = Trigger(false);
+  if (done) {
+    done(this);
+  }
+  return status;
+}
+
+void IExecutable::SetCallback(const IDevice::async_callback& cb) {
+  callback_ = cb;
+}
+
+void IExecutable::Wait() {
+  completion_.Wait();
+}
+
 NativeExecutable::NativeExecutable(const std::shared_ptr<IExecutor>& executor, const std::vector<char>& nb_buf, size_t inputs, size_t outputs) {
   executor_ = executor;
   context_ = executor->Contex();
@@ -129,12 +226,43 @@ bool NativeExecutable::Submit(const std::shared_ptr<IExecutable>& ref, bool afte
 }
 
 bool NativeExecutable::Trigger(bool async) {
-  (void)async;
-  bool status = false;
+  bool status = Launch(nullptr);
+  if (status && !async) {
+    Wait();
+  }
+  return status;
+}
+
+bool NativeExecutable::Launch(const IDevice::async_callback& done) {
   auto device = Executor()->Device();
-  device->Submit(nb_graph_);
-  status = device->Trigger();
-  device->WaitDeviceIdle();
+  // The callback holds a reference, the executable outlives its runs
+  std::shared_ptr<IExecutable> self = shared_from_this();
+  IDevice::async_callback user_cb = callback_;
+  // The user callback goes first: done may queue the next executable, whose
+  // callback must not overtake this one on another worker.
+  IDevice::async_callback cb = [this, self, done, user_cb](const void*) {
+    bool status = true;
+    if (user_cb) {
+      status = user_cb(this);
+    }
+    if (done) {
+      status = done(this) && status;
+    }
+    completion_.Finish();
+    return status;
+  };
+  completion_.Begin();
+  bool status = false;
+  auto native_device = dynamic_cast<NativeDeviceImpl*>(device.get());
+  if (native_device) {
+    status = native_device->Enqueue(nb_graph_, cb);
+  } else {
+    device->Submit(nb_graph_);
+    status = device->Trigger(true, cb);
+  }
+  if (!status) {
+    completion_.Finish();
+  }
   return status;
 }
 
@@ -174,14 +302,54 @@ bool ExecutableSet::Submit(const std::shared_ptr<IExecutable>& ref, bool after)
 }
 
 bool ExecutableSet::Trigger(bool async) {
-  (void)async;
-  bool status = false;
-  auto device = Executor()->Device();
+  bool status = Launch(nullptr);
+  if (status && !async) {
+    Wait();
+  }
+  return status;
+}
+
+bool ExecutableSet::Launch(const IDevice::async_callback& done) {
+  // The executables of a set run concurrently, the set completes with the
+  // last of them.
+  struct Pending {
+    std::mutex mtx;
+    size_t count;
+  };
+  auto pending = std::make_shared<Pending>();
+  pending->count = executables_.size();
+  std::shared_ptr<IExecutable> self = shared_from_this();
+  IDevice::async_callback user_cb = callback_;
+  IDevice::async_callback member_done = [this, self, pending, done, user_cb](const void*) {
+    {
+      std::lock_guard<std::mutex> lock(pending->mtx);
+      if (--pending->count > 0) {
+        return true;
+      }
+    }
+    // User callback first, as for a single executable
+    bool status = true;
+    if (user_cb) {
+      status = user_cb(this);
+    }
+    if (done) {
+      status = done(this) && status;
+    }
+    completion_.Finish();
+    return status;
+  };
+  completion_.Begin();
+  if (executables_.empty()) {
+    member_done(nullptr);
+    return true;
+  }
+  bool status = true;
   for ( auto executable : executables_ ) {
-    device->Submit(executable->NBGraph());
+    if (!executable->Launch(member_done)) {
+      status = false;
+      member_done(nullptr);  // count the failed executable as finished
+    }
   }
-  status = device->Trigger();
-  device->WaitDeviceIdle();
   return status;
 }
 
@@ -207,6 +375,10 @@ std::shared_ptr<Context> IExecutor::Contex() const {
   return context_;
 }
 
+void IExecutor::Wait() {
+  completion_.Wait();
+}
+
 NativeExecutor::NativeExecutor(const std::shared_ptr<IDevice>& device) {
   device_ = device;
   context_ = Context::Create();
@@ -245,19 +417,46 @@ bool NativeExecutor::Submit(const std::shared_ptr<IExecutable>& executable, cons
   return success;
 }
 
+// Launches tasks[index] and, from its completion, the task after it.
+static bool LaunchChain(const std::shared_ptr<std::vector<std::shared_ptr<IExecutable>>>& tasks,
+                        size_t index, const std::shared_ptr<IExecutor>& executor,
+                        Completion* completion) {
+  if (index >= tasks->size()) {
+    completion->Finish();
+    return true;
+  }
+  auto next = [tasks, index, executor, completion](const void*) {
+    return LaunchChain(tasks, index + 1, executor, completion);
+  };
+  if (!(*tasks)[index]->Launch(next)) {
+    completion->Finish();
+    return false;
+  }
+  return true;
+}
+
 bool NativeExecutor::Trigger(bool async) {
-  (void)async;
-  while (!tasks_.empty()) {
-    auto task = tasks_.front();
-    tasks_.erase(tasks_.begin());
+  auto tasks = std::make_shared<std::vector<std::shared_ptr<IExecutable>>>();
+  for (auto& task : tasks_) {
     auto task_ = task.lock();
     if (!task_) {
         std::cout<< "Task unable to lock weak_ptr";
+        continue;
     }
-    task_->Trigger();
+    tasks->push_back(task_);
   }
-  device_->WaitDeviceIdle();
-  return true;
+  tasks_.clear();
+  if (!async) {
+    bool status = true;
+    for (auto& task_ : *tasks) {
+      status = task_->Trigger() && status;
+    }
+    return status;
+  }
+  // Tasks depend on the ones submitted before them, so only one of them is
+  // queued on the device at a time.
+  completion_.Begin();
+  return LaunchChain(tasks, 0, shared_from_this(), &completion_);
 }
 
 std::shared_ptr<IExecutable> NativeExecutor::Compile(const std::shared_ptr<Graph>& graph) {
@@ -24,6 +24,9 @@
 #ifndef TIM_VX_NATIVE_DEVICE_PRIVATE_H_
 #define TIM_VX_NATIVE_DEVICE_PRIVATE_H_
 
+#include <deque>
+#include <utility>
+
 #include "tim/vx/platform/native.h"
 #include "vip/virtual_device.h"
 #include "graph_private.h"
@@ -37,17 +40,31 @@ namespace platform {
 
 class NativeDeviceImpl : public NativeDevice {
  public:
-  NativeDeviceImpl(device_id_t id);
+  NativeDeviceImpl(device_id_t id, uint32_t worker_count = vip::kDefaultWorkerCount,
+                   uint64_t cpu_mask = 0);
   ~NativeDeviceImpl(){};
 
   bool Submit(const std::shared_ptr<tim::vx::Graph>& graph) override;
   bool Trigger(bool async = false, async_callback cb = NULL) override;
   bool DeviceExit() override;
   void WaitDeviceIdle() override;
+  // Submit and trigger one graph at once, so concurrent callers can not
+  // pick up each other's graphs or callbacks.
+  bool Enqueue(const std::shared_ptr<tim::vx::Graph>& graph, async_callback cb);
 
  protected:
+  // Queues the graph on the vip device. Callbacks run on the device
+  // workers, where waiting for a full queue could wait for the worker
+  // itself, so graphs queued from a callback are parked in pending_
+  // instead and queued once the workers free a slot.
+  bool Queue(vsi_nn_graph_t* graph, const async_callback& cb);
+  void DrainPending();
+
   std::unique_ptr<vip::IDevice> vip_device_;
+  std::mutex graph_mtx_;
   std::vector<vsi_nn_graph_t*> vsi_graph_v_;
+  std::mutex pending_mtx_;
+  std::deque<std::pair<vsi_nn_graph_t*, vip::func_t>> pending_;
 
 };
 
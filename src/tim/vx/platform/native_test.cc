@@ -0,0 +1,146 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/vx/platform/native.h"
+#include "tim/vx/ops/elementwise.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+struct AddModel {
+  std::shared_ptr<tim::vx::platform::IExecutable> executable;
+  std::shared_ptr<tim::vx::platform::ITensorHandle> input;
+  std::shared_ptr<tim::vx::platform::ITensorHandle> output;
+};
+
+// out = in + in, compiled into an NBG executable of the executor's device
+AddModel CompileAdd(const std::shared_ptr<tim::vx::platform::IExecutor>& executor) {
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto graph = executor->Contex()->CreateGraph();
+  auto in = graph->CreateTensor(input_spec);
+  auto out = graph->CreateTensor(output_spec);
+  graph->CreateOperation<tim::vx::ops::Add>()->BindInputs({in, in}).BindOutput(out);
+
+  AddModel model;
+  model.executable = executor->Compile(graph);
+  model.input = model.executable->AllocateTensor(input_spec);
+  model.output = model.executable->AllocateTensor(output_spec);
+  model.executable->SetInput(model.input);
+  model.executable->SetOutput(model.output);
+  return model;
+}
+
+}  // namespace
+
+TEST(platform, async_trigger_invokes_callback) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  ASSERT_FALSE(devices.empty());
+  auto executor = std::make_shared<tim::vx::platform::NativeExecutor>(devices[0]);
+  auto model = CompileAdd(executor);
+  ASSERT_TRUE(model.executable->Verify());
+
+  std::atomic<int> calls(0);
+  const void* called_with = nullptr;
+  model.executable->SetCallback([&](const void* data) {
+    called_with = data;
+    calls++;
+    return true;
+  });
+
+  std::vector<float> in_data = {1.0f, 2.0f, 3.0f, 4.0f};
+  std::vector<float> out_data(in_data.size());
+  EXPECT_TRUE(model.input->CopyDataToTensor(in_data.data(), in_data.size() * sizeof(float)));
+  EXPECT_TRUE(model.executable->Trigger(true));
+  model.executable->Wait();
+  EXPECT_EQ(1, calls.load());
+  EXPECT_EQ(model.executable.get(), called_with);
+  EXPECT_TRUE(model.output->CopyDataFromTensor(out_data.data()));
+  EXPECT_EQ(std::vector<float>({2.0f, 4.0f, 6.0f, 8.0f}), out_data);
+
+  // A synchronous trigger runs the callback before returning
+  EXPECT_TRUE(model.executable->Trigger());
+  EXPECT_EQ(2, calls.load());
+}
+
+TEST(platform, async_executor_keeps_submission_order) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  ASSERT_FALSE(devices.empty());
+  auto executor = std::make_shared<tim::vx::platform::NativeExecutor>(devices[0]);
+  const size_t kCount = 4;
+  std::vector<AddModel> models;
+  std::mutex order_mtx;
+  std::vector<size_t> order;
+  for (size_t i = 0; i < kCount; i++) {
+    models.push_back(CompileAdd(executor));
+    models[i].executable->SetCallback([&, i](const void*) {
+      std::lock_guard<std::mutex> lock(order_mtx);
+      order.push_back(i);
+      return true;
+    });
+  }
+  EXPECT_TRUE(models[0].executable->Submit(models[0].executable));
+  for (size_t i = 1; i < kCount; i++) {
+    EXPECT_TRUE(models[i].executable->Submit(models[i - 1].executable));
+  }
+
+  EXPECT_TRUE(executor->Trigger(true));
+  executor->Wait();
+  EXPECT_EQ(std::vector<size_t>({0, 1, 2, 3}), order);
+}
+
+TEST(platform, async_trigger_keeps_devices_busy_from_one_thread) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  ASSERT_FALSE(devices.empty());
+  std::vector<std::shared_ptr<tim::vx::platform::IExecutor>> executors;
+  std::vector<AddModel> models;
+  std::atomic<int> calls(0);
+  for (auto& device : devices) {
+    executors.push_back(std::make_shared<tim::vx::platform::NativeExecutor>(device));
+    models.push_back(CompileAdd(executors.back()));
+    models.back().executable->SetCallback([&](const void*) {
+      calls++;
+      return true;
+    });
+  }
+
+  // Every device gets work queued before the host waits on any of them
+  const int kRounds = 8;
+  for (int round = 0; round < kRounds; round++) {
+    for (auto& model : models) {
+      EXPECT_TRUE(model.executable->Trigger(true));
+    }
+    for (auto& model : models) {
+      model.executable->Wait();
+    }
+  }
+  EXPECT_EQ(kRounds * static_cast<int>(models.size()), calls.load());
+}
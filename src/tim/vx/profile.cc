@@ -0,0 +1,105 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/profile.h"
+
+#include <sstream>
+
+namespace tim {
+namespace vx {
+
+namespace {
+std::string Quote(const std::string& str) {
+  std::string quoted("\"");
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      quoted += '\\';
+    }
+    quoted += c;
+  }
+  return quoted + "\"";
+}
+
+// Trace timestamps are in microseconds
+double ToUs(uint64_t ns) { return ns / 1000.0; }
+}  // namespace
+
+std::string GraphProfile::ToJson() const {
+  std::ostringstream ss;
+  ss << "{\"runs\": [";
+  for (size_t i = 0; i < runs.size(); ++i) {
+    ss << (i ? ", " : "") << "{\"start_ns\": " << runs[i].start_ns
+       << ", \"duration_ns\": " << runs[i].duration_ns << "}";
+  }
+  ss << "], \"ops\": [";
+  for (size_t i = 0; i < ops.size(); ++i) {
+    const auto& op = ops[i];
+    ss << (i ? ", " : "") << "{\"name\": " << Quote(op.name)
+       << ", \"kernel_type\": " << Quote(op.kernel_type)
+       << ", \"input_bytes\": " << op.input_bytes
+       << ", \"output_bytes\": " << op.output_bytes << ", \"time_ns\": [";
+    for (size_t j = 0; j < op.samples.size(); ++j) {
+      ss << (j ? ", " : "") << op.samples[j].duration_ns;
+    }
+    ss << "]}";
+  }
+  ss << "]}";
+  return ss.str();
+}
+
+std::string GraphProfile::ToChromeTrace() const {
+  std::ostringstream ss;
+  uint64_t origin = runs.empty() ? 0 : runs.front().start_ns;
+  bool first = true;
+  auto event = [&](const std::string& name, const char* category, int tid,
+                   uint64_t start_ns, uint64_t duration_ns) -> std::ostream& {
+    ss << (first ? "" : ",\n") << "{\"name\": " << Quote(name)
+       << ", \"cat\": \"" << category << "\", \"ph\": \"X\", \"pid\": 0"
+       << ", \"tid\": " << tid << ", \"ts\": " << ToUs(start_ns - origin)
+       << ", \"dur\": " << ToUs(duration_ns);
+    first = false;
+    return ss;
+  };
+
+  ss << "{\"traceEvents\": [\n";
+  for (size_t i = 0; i < runs.size(); ++i) {
+    event("Run", "graph", 0, runs[i].start_ns, runs[i].duration_ns)
+        << ", \"args\": {\"run\": " << i << "}}";
+    for (const auto& op : ops) {
+      if (i >= op.samples.size()) {
+        continue;
+      }
+      const auto& sample = op.samples[i];
+      event(op.name, "op", 1, runs[i].start_ns + sample.start_ns,
+            sample.duration_ns)
+          << ", \"args\": {\"kernel_type\": " << Quote(op.kernel_type)
+          << ", \"input_bytes\": " << op.input_bytes
+          << ", \"output_bytes\": " << op.output_bytes << "}}";
+    }
+  }
+  ss << "\n], \"displayTimeUnit\": \"ns\"}";
+  return ss.str();
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -123,6 +123,7 @@ bool TensorImpl::CopyDataToTensor(const void* data, uint32_t size_in_bytes) {
   bool retn = true;
   if (data && VSI_NN_TENSOR_ID_NA != id_) {
     retn = false;
+    graph_->RestoreHandle(id_);
     vsi_nn_tensor_t* tensor = vsi_nn_GetTensor(graph_->graph(), id_);
     if (tensor) {
       uint32_t tensor_bytes = vsi_nn_GetTensorSize(
@@ -141,14 +142,12 @@ bool TensorImpl::CopyDataToTensor(const void* data, uint32_t size_in_bytes) {
       }
       else {
         /*
-        argument `data` of vsi_nn_CopyDataToTensor is non-const
-        convert it from const data to non-const, will be fixed in ovxlib
+        argument `data` of vsi_nn_CopyDataToTensor is non-const but it is
+        only read from, will be fixed in ovxlib
         */
-        const uint8_t* end = static_cast<const uint8_t*>(data) + tensor_bytes;
-        std::vector<uint8_t> data_copy(static_cast<const uint8_t*>(data), end);
-
         retn = (VSI_SUCCESS ==
-             vsi_nn_CopyDataToTensor(graph_->graph(), tensor, data_copy.data()));
+             vsi_nn_CopyDataToTensor(graph_->graph(), tensor,
+                                     const_cast<void*>(data)));
       }
     }
   }
@@ -163,6 +162,7 @@ bool TensorImpl::CopyDataFromTensor(void* data) {
   bool retn = true;
   if (data && VSI_NN_TENSOR_ID_NA != id_) {
     retn = false;
+    graph_->RestoreHandle(id_);
     vsi_nn_tensor_t* tensor = vsi_nn_GetTensor(graph_->graph(), id_);
 
     if (tensor) {
@@ -237,6 +237,7 @@ void* TensorImpl::map(bool invalidate_cpu_cache) {
 
   void* cpu_ptr = nullptr;
   if (VSI_NN_TENSOR_ID_NA != id_) {
+    graph_->RestoreHandle(id_);
     vsi_nn_tensor_t* tensor = vsi_nn_GetTensor(graph_->graph(), id_);
     if (tensor && tensor->attr.is_created_from_handle) {
       // Here `cpu_cache` means L1/L2/... cache on a CPU chip.